@@ -10,15 +10,28 @@
 #include <istream>
 #include <sstream>
 #include <map>
-#include <unordered_set>
 
 #include "Vertica.h"
 #include "VerticaDFS.h"
 #include "DFSUtil.hpp"
+#include "ConfigCache.hpp"
+#include "Tokenizer.hpp"
 
 using namespace Vertica;
 using namespace std;
 
+// parameter name for flag to add the token_hash output column
+const string TOKEN_HASH_PARAM = "token_hash";
+
+/**
+ * Check if the token_hash output column is requested.
+ */
+static bool isTokenHashEnabled(ServerInterface &srvInterface)
+{
+    ParamReader paramReader = srvInterface.getParamReader();
+    return paramReader.containsParameter(TOKEN_HASH_PARAM) && paramReader.getBoolRef(TOKEN_HASH_PARAM) == vbool_true;
+}
+
 /**
  * AdvancedStringTokenizer : Transform function class
  */
@@ -26,116 +39,148 @@ class AdvancedStringTokenizer : public TransformFunction
 {
 
 private:
-    vector<size_t> inputCols; // Data member to store the passed arguments
-    unordered_set<string> stopWordsCaseInsensitive = {}; // List of stop words
-    string minorSeparators = "";          // Minor separators
-    string majorSeparators = "";          // Major separetors
-    size_t minLength = 0;                 // Min length of token
-    size_t maxLength = MAX_STRING_LENGTH; // Max length of token
-    bool prevCharMinorSep = false;        // Flag to indicate the previous character is minor separator
-    bool prevCharMajorSep = false;        // Flag to indicate the previous character is major separator
-
-    DFSFile file;
-    DFSFileReader fileReader;
+    vector<size_t> inputCols;  // Data member to store the passed arguments
+    Tokenizer tokenizer;       // Tokenizer with the compiled configuration parameters
     DFSUtil dfsUtil = DFSUtil();
-    map<string, string> parameters; // key-value pairs of parameter and value
-
-    /**
-     * Check for pass-through inputs.
-     */
-    void handlePassThroughInputs(ServerInterface &srvInterface,
-                                 PartitionReader &inputReader,
-                                 PartitionWriter &outputWriter)
-    {
-        if (inputCols.size() > 2) {
-            size_t outputIdx = 1;
-            for (size_t inputIdx = 2; inputIdx < inputCols.size(); inputIdx++) {
-                outputWriter.copyFromInput(outputIdx, inputReader, inputIdx);
-                outputIdx++;
-            }
-        }
-    }
+    string filePath;           // Path of DFS file for the selected profile
+    bool tokenHash = false;    // Flag to output the hash of token
+    size_t emittedTokens = 0;  // Tokens written to the output by this instance
+    size_t filteredTokens = 0; // Tokens dropped by the filters in this instance
 
     /**
-     * Check if input character is one of major separator.
+     * PassThroughValue : Value of a pass-through column resolved once per input row
      */
-    bool isMajorSeparator(char data)
-    {
-        bool flag = isSeparator(data, majorSeparators);
-        if (!flag) {
-            setPrevCharMajorSep(false);
-        }
-        return flag;
-    }
+    struct PassThroughValue {
+        enum Kind { KIND_INT, KIND_FLOAT, KIND_BOOL, KIND_DATE, KIND_TIMESTAMP, KIND_TIMESTAMPTZ, KIND_STRING, KIND_GENERIC };
+
+        Kind kind;             // How the value is read and written
+        size_t inputIdx;       // Index of input column
+        size_t outputIdx;      // Index of output column
+        vint intValue;         // Value of INTEGER, DATE, TIMESTAMP and TIMESTAMPTZ, including the null value
+        vfloat floatValue;     // Value of FLOAT, including the null value
+        vbool boolValue;       // Value of BOOLEAN, including the null value
+        const VString *string; // Value of string types, which is valid until the input moves to the next row
+    };
+    vector<PassThroughValue> passThrough; // Pass-through columns
 
     /**
-     * Check if input character is one of minor separator.
+     * Decide how each pass-through column is copied from its data type.
      */
-    bool isMinorSeparator(char data)
+    void setupPassThroughInputs(const SizedColumnTypes &argTypes)
     {
-        bool flag = isSeparator(data, minorSeparators);
-        if (!flag) {
-            setPrevCharMinorSep(false);
+        passThrough.clear();
+        size_t outputIdx = tokenHash ? 2 : 1;
+        for (size_t inputIdx = 2; inputIdx < inputCols.size(); inputIdx++) {
+            PassThroughValue value = PassThroughValue();
+            switch (argTypes.getColumnType(inputCols[inputIdx]).getTypeOid()) {
+            case Int8OID:
+                value.kind = PassThroughValue::KIND_INT;
+                break;
+            case Float8OID:
+                value.kind = PassThroughValue::KIND_FLOAT;
+                break;
+            case BoolOID:
+                value.kind = PassThroughValue::KIND_BOOL;
+                break;
+            case DateOID:
+                value.kind = PassThroughValue::KIND_DATE;
+                break;
+            case TimestampOID:
+                value.kind = PassThroughValue::KIND_TIMESTAMP;
+                break;
+            case TimestampTzOID:
+                value.kind = PassThroughValue::KIND_TIMESTAMPTZ;
+                break;
+            case CharOID:
+            case VarcharOID:
+            case LongVarcharOID:
+            case BinaryOID:
+            case VarbinaryOID:
+            case LongVarbinaryOID:
+                value.kind = PassThroughValue::KIND_STRING;
+                break;
+            default: // NUMERIC, INTERVAL, complex types etc.
+                value.kind = PassThroughValue::KIND_GENERIC;
+                break;
+            }
+            value.inputIdx = inputIdx;
+            value.outputIdx = outputIdx++;
+            passThrough.push_back(value);
         }
-        return flag;
     }
 
     /**
-     * Check if input character is one of separator passed through argument.
+     * Read the pass-through inputs of the current row.
      */
-    bool isSeparator(char data, string separators)
+    void readPassThroughInputs(PartitionReader &inputReader)
     {
-        for (size_t i = 0; i < separators.size(); ++i) {
-            if (data == separators[i]) {
-                return true;
+        for (PassThroughValue &value : passThrough) {
+            switch (value.kind) {
+            case PassThroughValue::KIND_INT:
+                value.intValue = inputReader.getIntRef(value.inputIdx);
+                break;
+            case PassThroughValue::KIND_FLOAT:
+                value.floatValue = inputReader.getFloatRef(value.inputIdx);
+                break;
+            case PassThroughValue::KIND_BOOL:
+                value.boolValue = inputReader.getBoolRef(value.inputIdx);
+                break;
+            case PassThroughValue::KIND_DATE:
+                value.intValue = inputReader.getDateRef(value.inputIdx);
+                break;
+            case PassThroughValue::KIND_TIMESTAMP:
+                value.intValue = inputReader.getTimestampRef(value.inputIdx);
+                break;
+            case PassThroughValue::KIND_TIMESTAMPTZ:
+                value.intValue = inputReader.getTimestampTzRef(value.inputIdx);
+                break;
+            case PassThroughValue::KIND_STRING:
+                value.string = &inputReader.getStringRef(value.inputIdx);
+                break;
+            default:
+                break;
             }
         }
-        return false;
-    }
-
-    /**
-     * Get the flag that indicates the previous character is major separator
-     */
-    bool isPrevCharMajorSep()
-    {
-        return prevCharMajorSep;
-    }
-
-    /**
-     * Get the flag that indicates the previous character is minor separator
-     */
-    bool isPrevCharMinorSep()
-    {
-        return prevCharMinorSep;
-    }
-
-    /**
-     * Set the flag that indicates the previous character is major separator
-     */
-    void setPrevCharMajorSep(bool flag)
-    {
-        prevCharMajorSep = flag;
-    }
-
-    /**
-     * Set the flag that indicates the previous character is minor separator
-     */
-    void setPrevCharMinorSep(bool flag)
-    {
-        prevCharMinorSep = flag;
     }
 
     /**
-     * Check if input word is one of stop words.
+     * Write the pass-through inputs of the current row to the output row.
      */
-    bool isStopWord(VString word)
+    void handlePassThroughInputs(PartitionReader &inputReader,
+                                 PartitionWriter &outputWriter)
     {
-        string str = word.str();
-        transform(str.cbegin(), str.cend(), str.begin(), [](char c) { return tolower(c); });
-        if (!str.empty() && stopWordsCaseInsensitive.find(str) != stopWordsCaseInsensitive.end()) {
-            return true;
+        for (const PassThroughValue &value : passThrough) {
+            switch (value.kind) {
+            case PassThroughValue::KIND_INT:
+                outputWriter.setInt(value.outputIdx, value.intValue);
+                break;
+            case PassThroughValue::KIND_FLOAT:
+                outputWriter.setFloat(value.outputIdx, value.floatValue);
+                break;
+            case PassThroughValue::KIND_BOOL:
+                outputWriter.setBool(value.outputIdx, value.boolValue);
+                break;
+            case PassThroughValue::KIND_DATE:
+                outputWriter.setDate(value.outputIdx, value.intValue);
+                break;
+            case PassThroughValue::KIND_TIMESTAMP:
+                outputWriter.setTimestamp(value.outputIdx, value.intValue);
+                break;
+            case PassThroughValue::KIND_TIMESTAMPTZ:
+                outputWriter.setTimestampTz(value.outputIdx, value.intValue);
+                break;
+            case PassThroughValue::KIND_STRING:
+                if (value.string->isNull()) {
+                    outputWriter.setNull(value.outputIdx);
+                } else {
+                    outputWriter.getStringRef(value.outputIdx).copy(value.string->data(), value.string->length());
+                }
+                break;
+            default:
+                outputWriter.copyFromInput(value.outputIdx, inputReader, value.inputIdx);
+                break;
+            }
         }
-        return false;
     }
 
 public:
@@ -145,51 +190,16 @@ public:
      */
     void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) override
     {
+        // Get the path of DFS file for the selected profile
+        filePath = dfsUtil.getFilePath(srvInterface);
+
         // Get all passed arguments
         argTypes.getArgumentColumns(inputCols);
+        tokenHash = isTokenHashEnabled(srvInterface);
+        setupPassThroughInputs(argTypes);
 
-        // Open DFS file and read the configuration parameters
-        file = DFSFile(srvInterface, dfsUtil.FILE_PATH);
-        if (!file.exists()) {
-            vt_report_error(0, "The DFS file [%s] does not exist", dfsUtil.FILE_PATH.c_str());
-        } else {
-            fileReader = DFSFileReader(file);
-            fileReader.open();
-            dfsUtil.readParameters(srvInterface, fileReader, parameters);
-            fileReader.close();
-        }
-
-        // Set the configuration parameters
-        for (const auto& x : parameters) {
-            if (x.first == PARAM_STOPWORDSCASEINSENSITIVE) { // stopwordscaseinsensitive
-                stringstream ss{x.second};
-                string buf;
-                while (getline(ss, buf, ',')) {
-                    if (!buf.empty()) {
-                        stopWordsCaseInsensitive.insert(buf);
-                    }
-                }
-                ss.clear();
-            } else if (x.first == PARAM_MINORSEPARATORS) { // minorseparators
-                minorSeparators = x.second;
-            } else if (x.first == PARAM_MAJORSEPARATORS) { // majorseparators
-                majorSeparators = x.second;
-            } else if (x.first == PARAM_MINLENGTH) { // minlength
-                minLength = stoul(x.second, nullptr, 10);
-            } else if (x.first == PARAM_MAXLENGTH) { // maxlength
-                maxLength = stoul(x.second, nullptr, 10);
-            }
-        }
-    }
-
-    /**
-     * Destructor.
-     */
-    void destroy(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) override
-    {
-        if (fileReader.isOpen()) {
-            fileReader.close();
-        }
+        // Get the configuration parameters compiled from DFS file, which are shared by all instances in this process
+        tokenizer.config = ConfigCache::get(srvInterface, filePath);
     }
 
     /**
@@ -203,71 +213,39 @@ public:
             vt_report_error(0, "Function only accepts 2 or more arguments, but %zu provided", inputReader.getNumCols());
         }
 
+        // Only the tokens which survive the filters are written to the output
+        auto emit = [&](const char *data, size_t length) {
+            VString &word = outputWriter.getStringRef(0);
+            word.copy(data, length);
+            if (tokenHash) {
+                outputWriter.setInt(1, static_cast<vint>(Tokenizer::hashToken(data, length)));
+            }
+            handlePassThroughInputs(inputReader, outputWriter);
+            outputWriter.next();
+            ++emittedTokens;
+        };
+
         // Loop until the reader has the inputs
         do {
             // Read the text field
             const VString &sentence = inputReader.getStringRef(1);
 
             if (!sentence.isNull()) {
-                size_t wordStart = 0, wordEnd = 0, wordMinorStart = 0;
-                bool majorFlag = false, minorFlag = false;
-
-                const char *sentenceData = sentence.data();
-                size_t sentenseLength = sentence.length();
-
-                while (wordEnd < sentenseLength) {
-                    // Skip reading the characters until major/minor separator appears
-                    while (wordEnd < sentenseLength) {
-                        if (isMajorSeparator(sentenceData[wordEnd])) {
-                            majorFlag = true;
-                            break;
-                        } else if (isMinorSeparator(sentenceData[wordEnd])) {
-                            minorFlag = true;
-                            break;
-                        }
-                        ++wordEnd;
-                    }
-
-                    // Create a token using minor separator
-                    if (minorFlag || wordStart != wordMinorStart) {
-                        if (!isPrevCharMajorSep() && !isPrevCharMinorSep() && minLength <= wordEnd - wordMinorStart) {
-                            VString &word = outputWriter.getStringRef(0);
-                            word.copy(&sentenceData[wordMinorStart], (maxLength < wordEnd - wordMinorStart) ? maxLength : wordEnd - wordMinorStart);
-                            if (!isStopWord(word)) {
-                                handlePassThroughInputs(srvInterface, inputReader, outputWriter);
-                                outputWriter.next();
-                            }
-                        }
-
-                        wordMinorStart = wordEnd + 1;
-                        setPrevCharMinorSep(true);
-                        minorFlag = false;
-                    }
-
-                    // Create a token using major separator
-                    if (majorFlag || sentenseLength == wordEnd || sentenseLength == wordMinorStart) {
-                        if (!majorFlag && sentenseLength == wordMinorStart) {
-                            ++wordEnd;
-                        }
-                        if (!isPrevCharMajorSep() && minLength <= wordEnd - wordStart) {
-                            VString &word = outputWriter.getStringRef(0);
-                            word.copy(&sentenceData[wordStart], (maxLength < wordEnd - wordStart) ? maxLength : wordEnd - wordStart);
-                            if (!isStopWord(word)) {
-                                handlePassThroughInputs(srvInterface, inputReader, outputWriter);
-                                outputWriter.next();
-                            }
-                        }
-
-                        wordStart = wordEnd + 1;
-                        wordMinorStart = wordStart;
-                        setPrevCharMajorSep(true);
-                        majorFlag = false;
-                    }
-
-                    ++wordEnd;
-                }
+                readPassThroughInputs(inputReader);
+                tokenizer.tokenize(sentence.data(), sentence.length(), emit);
             }
         } while (inputReader.next());
+
+        filteredTokens += tokenizer.takeFilteredTokens();
+    }
+
+    /**
+     * Log the number of tokens once per instance, instead of once per partition, and stop the threads.
+     */
+    void destroy(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) override
+    {
+        srvInterface.log("AdvancedStringTokenizer: %zu tokens emitted, %zu tokens filtered", emittedTokens, filteredTokens);
+        tokenizer.releaseThreads();
     }
 
 };
@@ -289,6 +267,16 @@ public:
         returnType.addAny();
     }
 
+    /**
+     * Define parameters.
+     */
+    void getParameterType(ServerInterface &srvInterface, SizedColumnTypes &parameterTypes) override
+    {
+        DFSUtil().addProfileParameter(parameterTypes);
+        parameterTypes.addBool(TOKEN_HASH_PARAM, SizedColumnTypes::Properties(true /* visible */, false /* required */, false /* canBeNull */,
+                                                                              "Flag to output the 64-bit hash of token", false /* isSortedOnThis */));
+    }
+
     /**
      * Register the data type of outputs.
      */
@@ -315,6 +303,9 @@ public:
         } else {
             vt_report_error(0, "Second argument to tokenizer must be of varchar type.");
         }
+        if (isTokenHashEnabled(srvInterface)) {
+            outputTypes.addInt("token_hash");
+        }
 
         // Handle output rows for added pass-through inputs
         vector<size_t> argCols;
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: ConfigCache : Process-wide cache of the compiled configuration parameters
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "Vertica.h"
+#include "VerticaDFS.h"
+#include "DFSUtil.hpp"
+#include "ConfigCache.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+mutex ConfigCache::lock;
+map<string, ConfigCache::Entry> ConfigCache::entries;
+uint64_t ConfigCache::lastVersion = 0;
+
+/**
+ * Get the compiled configuration of the DFS file. Only the stamp at the beginning of the file is read while
+ * the cached configuration is up to date, and the file is read and compiled again when the stamp differs,
+ * which happens when the file is written on any node. A file without the stamp is compared by its contents.
+ */
+shared_ptr<const TokenizerConfig> ConfigCache::get(ServerInterface &srvInterface, const string &path)
+{
+    DFSUtil dfsUtil = DFSUtil();
+    DFSFile file = DFSFile(srvInterface, path);
+    if (!file.exists()) {
+        invalidate(path);
+        vt_report_error(0, "The DFS file [%s] does not exist", path.c_str());
+    }
+
+    DFSFileReader fileReader = DFSFileReader(file);
+    fileReader.open();
+    const size_t fileSize = fileReader.size();
+    string contents(min(fileSize, dfsUtil.stampEntryLength()), '\0');
+    contents.resize(contents.empty() ? 0 : fileReader.read(&contents[0], contents.size()));
+    string identity = dfsUtil.parseStamp(contents);
+    bool complete = contents.size() == fileSize;
+    if (identity.empty()) { // Written without the stamp
+        readRest(fileReader, fileSize, contents);
+        complete = true;
+        identity = contents;
+    }
+
+    {
+        lock_guard<mutex> guard(lock);
+        map<string, Entry>::iterator it = entries.find(path);
+        if (it != entries.end() && it->second.identity == identity) {
+            fileReader.close();
+            return it->second.config;
+        }
+    }
+
+    if (!complete) {
+        readRest(fileReader, fileSize, contents);
+    }
+    fileReader.close();
+
+    map<string, string> parameters; // key-value pairs of parameter and value
+    dfsUtil.parseParameters(contents, parameters);
+    shared_ptr<TokenizerConfig> config = make_shared<TokenizerConfig>();
+    config->maxLength = MAX_STRING_LENGTH;
+    try {
+        config->compile(parameters);
+    } catch (exception &e) {
+        vt_report_error(0, "Invalid configuration in the DFS file [%s]: %s", path.c_str(), e.what());
+    }
+
+    // Another instance may have compiled the same file in the meantime, and the first one is shared
+    lock_guard<mutex> guard(lock);
+    Entry &entry = entries[path];
+    if (!entry.config || entry.identity != identity) {
+        config->version = ++lastVersion;
+        srvInterface.log("AdvancedStringTokenizer: compiled configuration [%s] version %llu", path.c_str(), static_cast<unsigned long long>(config->version));
+        entry.identity.swap(identity);
+        entry.config = config;
+    }
+    return entry.config;
+}
+
+/**
+ * Append the rest of the DFS file to the contents read so far.
+ */
+void ConfigCache::readRest(DFSFileReader &fileReader, size_t fileSize, string &contents)
+{
+    size_t offset = contents.size();
+    if (fileSize <= offset) {
+        return;
+    }
+    try {
+        contents.resize(fileSize);
+    } catch (bad_alloc &e) {
+        vt_report_error(0, "Could not allocate [%zu] bytes", fileSize);
+    }
+    contents.resize(offset + fileReader.read(&contents[offset], fileSize - offset));
+}
+
+/**
+ * Drop the cached configuration of the DFS file.
+ */
+void ConfigCache::invalidate(const string &path)
+{
+    lock_guard<mutex> guard(lock);
+    entries.erase(path);
+}
@@ -0,0 +1,50 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: ConfigCache : Header file of ConfigCache.cpp
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef CONFIG_CACHE_HPP
+#define CONFIG_CACHE_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "Vertica.h"
+#include "VerticaDFS.h"
+#include "TokenizerConfig.hpp"
+
+/**
+ * ConfigCache : Process-wide cache of the compiled configurations shared by all instances
+ *
+ * An entry is keyed by the DFS file path and holds the stamp which SetAdvancedStringTokenizerParameter
+ * writes at the beginning of the file, so a file changed on another node is detected by reading the stamp
+ * instead of the whole file. SetAdvancedStringTokenizerParameter and DeleteAdvancedStringTokenizerConfigurationFile
+ * also invalidate the entry of the file they write in their own process.
+ */
+class ConfigCache
+{
+
+public:
+    static std::shared_ptr<const TokenizerConfig> get(Vertica::ServerInterface &srvInterface, const std::string &path);
+    static void invalidate(const std::string &path);
+
+private:
+    struct Entry {
+        std::string identity;                          // Stamp of the DFS file, or its contents if it has no stamp
+        std::shared_ptr<const TokenizerConfig> config; // Configuration compiled from the file
+    };
+
+    static void readRest(Vertica::DFSFileReader &fileReader, size_t fileSize, std::string &contents);
+
+    static std::mutex lock;
+    static std::map<std::string, Entry> entries; // Compiled configurations by the DFS file path
+    static uint64_t lastVersion;
+};
+
+#endif // CONFIG_CACHE_HPP
@@ -7,8 +7,11 @@
  * Author: Hibiki Serizawa
  */
 
+#include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <map>
+#include <random>
 #include <string>
 
 #include "Vertica.h"
@@ -18,12 +21,52 @@
 using namespace Vertica;
 using namespace std;
 
+/**
+ * Get the path of DFS file for the profile selected by the function parameter or the session parameter.
+ * If no profile is selected, the default DFS file is used.
+ */
+string DFSUtil::getFilePath(ServerInterface &srvInterface)
+{
+    string profile = "";
+    ParamReader paramReader = srvInterface.getParamReader();
+    ParamReader sessionParams = srvInterface.getUDSessionParamReader("library");
+    if (paramReader.containsParameter(PROFILE_PARAM)) {
+        profile = paramReader.getStringRef(PROFILE_PARAM).str();
+    } else if (sessionParams.containsParameter(PROFILE_PARAM)) {
+        profile = sessionParams.getStringRef(PROFILE_PARAM).str();
+    }
+
+    if (profile.empty()) {
+        return FILE_PATH;
+    }
+    for (size_t i = 0; i < profile.size(); ++i) {
+        if (!isalnum(static_cast<unsigned char>(profile[i])) && profile[i] != '_') {
+            vt_report_error(0, "Invalid profile '%s'; the profile must consist of alphanumeric characters and underscores.", profile.c_str());
+        }
+    }
+    return PROFILE_DIR + profile;
+}
+
+/**
+ * Add the parameter to select the profile.
+ */
+void DFSUtil::addProfileParameter(SizedColumnTypes &parameterTypes)
+{
+    parameterTypes.addVarchar(128, PROFILE_PARAM, SizedColumnTypes::Properties(true /* visible */, false /* required */, false /* canBeNull */,
+                                                                               "Name of configuration profile", false /* isSortedOnThis */));
+}
+
 /**
  * Write configuration parameters into DFS file.
  */
 void DFSUtil::writeParameters(ServerInterface &srvInterface, DFSFileWriter &fileWriter, map<string, string> &parameters)
 {
+    // The stamp is written first, so that the cached configuration is checked by reading only this entry
+    random_device device;
+    uint64_t stamp = (static_cast<uint64_t>(device()) << 32) ^ device()
+                     ^ static_cast<uint64_t>(chrono::system_clock::now().time_since_epoch().count());
     stringstream ss;
+    ss << hex << setw(4) << setfill('0') << stampEntryLength() - 4 << STAMP_PARAM << "=" << setw(16) << stamp;
     for (const auto& x : parameters) {
         stringstream buf;
         buf << x.first;
@@ -45,33 +88,69 @@ void DFSUtil::writeParameters(ServerInterface &srvInterface, DFSFileWriter &file
  * Read configuration parameters from DFS file.
  */
 void DFSUtil::readParameters(ServerInterface &srvInterface, DFSFileReader &fileReader, map<string, string> &parameters)
+{
+    string contents;
+    readContents(srvInterface, fileReader, contents);
+    parseParameters(contents, parameters);
+}
+
+/**
+ * Read the whole contents of DFS file.
+ */
+void DFSUtil::readContents(ServerInterface &srvInterface, DFSFileReader &fileReader, string &contents)
 {
     const size_t fileSize = fileReader.size();
 
-    unsigned char* idxBytes = nullptr;
     try {
-        idxBytes = new unsigned char[fileSize];
+        contents.resize(fileSize);
     } catch (bad_alloc &e) {
         vt_report_error(0, "Could not allocate [%zu] bytes", fileSize);
     }
 
-    const size_t readSize = fileReader.read(idxBytes, fileSize);
-    if (readSize == 0) {
-        delete []idxBytes;
-        return;
+    const size_t readSize = fileSize == 0 ? 0 : fileReader.read(&contents[0], fileSize);
+    contents.resize(readSize);
+}
+
+/**
+ * Parse the contents of DFS file into configuration parameters.
+ * Each entry is a 4-digit hex length followed by "parameter=value".
+ */
+void DFSUtil::parseParameters(const string &contents, map<string, string> &parameters)
+{
+    size_t pos = 0;
+    while (pos + 4 <= contents.size()) {
+        size_t paramLen = stoul(contents.substr(pos, 4), nullptr, 16);
+        size_t lineStart = pos + 4;
+        size_t lineEnd = min(lineStart + paramLen, contents.size());
+        size_t separator = contents.find('=', lineStart);
+        if (separator == string::npos || separator >= lineEnd) {
+            vt_report_error(0, "Invalid entry at offset [%zu] of the DFS file", pos);
+        }
+        string parameter = contents.substr(lineStart, separator - lineStart);
+        if (parameter != STAMP_PARAM) {
+            parameters.emplace(parameter, contents.substr(separator + 1, lineEnd - separator - 1));
+        }
+        pos = lineEnd;
     }
+}
 
-    string readString(reinterpret_cast<char*> (idxBytes), fileSize);
+/**
+ * Get the length of the stamp entry at the beginning of DFS file.
+ */
+size_t DFSUtil::stampEntryLength()
+{
+    return 4 + STAMP_PARAM.size() + 17;
+}
 
-    while (!readString.empty()) {
-        string paramHex = readString.substr(0, 4);
-        size_t paramLen = stoi(paramHex, nullptr, 16);
-        string line = readString.substr(4, paramLen);
-        string parameter = line.substr(0, line.find_first_of("=", 0));
-        string value = line.substr(parameter.size() + 1);
-        parameters.emplace(parameter, value);
-        readString.erase(0, paramLen + 4);
+/**
+ * Get the stamp from the beginning of the contents of DFS file, or an empty string if the file was written
+ * without the stamp.
+ */
+string DFSUtil::parseStamp(const string &contents)
+{
+    const string prefix = contents.substr(0, 4 + STAMP_PARAM.size() + 1);
+    if (contents.size() < stampEntryLength() || prefix.compare(4, string::npos, STAMP_PARAM + "=") != 0) {
+        return "";
     }
-
-    delete []idxBytes;
+    return contents.substr(prefix.size(), 16);
 }
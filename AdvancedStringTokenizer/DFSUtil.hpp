@@ -12,15 +12,15 @@
 
 #include "Vertica.h"
 #include "VerticaDFS.h"
+#include "TokenizerConfig.hpp"
 
 using namespace Vertica;
 using namespace std;
 
-const string PARAM_STOPWORDSCASEINSENSITIVE = "stopwordscaseinsensitive";
-const string PARAM_MINORSEPARATORS = "minorseparators";
-const string PARAM_MAJORSEPARATORS = "majorseparators";
-const string PARAM_MINLENGTH = "minlength";
-const string PARAM_MAXLENGTH = "maxlength";
+const string PROFILE_PARAM = "profile";
+
+// Entry written first in DFS file, whose value changes every time the file is written
+const string STAMP_PARAM = "_stamp";
 
 class DFSUtil
 {
@@ -28,7 +28,15 @@ class DFSUtil
     public:
         DFSUtil() {}
         const std::string FILE_PATH = "advancedStringTokenizer/config";
+        const std::string PROFILE_DIR = "advancedStringTokenizer/profiles/";
+
+        string getFilePath(ServerInterface &srvInterface);
+        void addProfileParameter(SizedColumnTypes &parameterTypes);
 
         void writeParameters(ServerInterface &srvInterface, DFSFileWriter &fileWriter, map<string, string> &parameters);
         void readParameters(ServerInterface &srvInterface, DFSFileReader &fileReader, map<string, string> &parameters);
+        void readContents(ServerInterface &srvInterface, DFSFileReader &fileReader, string &contents);
+        void parseParameters(const string &contents, map<string, string> &parameters);
+        size_t stampEntryLength();
+        string parseStamp(const string &contents);
 };
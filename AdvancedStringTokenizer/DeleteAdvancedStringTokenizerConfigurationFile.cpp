@@ -12,6 +12,7 @@
 #include "Vertica.h"
 #include "VerticaDFS.h"
 #include "DFSUtil.hpp"
+#include "ConfigCache.hpp"
 
 using namespace Vertica;
 using namespace std;
@@ -25,6 +26,7 @@ class DeleteAdvancedStringTokenizerConfigurationFile : public ScalarFunction
 private:
     DFSFile file;
     DFSUtil dfsUtil = DFSUtil();
+    string filePath; // Path of DFS file for the selected profile
 
 public:
 
@@ -33,12 +35,16 @@ public:
      */
     void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) override
     {
+        // Get the path of DFS file for the selected profile
+        filePath = dfsUtil.getFilePath(srvInterface);
+
         // Delete DFS file
-        file = DFSFile(srvInterface, dfsUtil.FILE_PATH);
+        file = DFSFile(srvInterface, filePath);
         if (!file.exists()) {
-            vt_report_error(0, "The DFS file [%s] does not exist", dfsUtil.FILE_PATH.c_str());
+            vt_report_error(0, "The DFS file [%s] does not exist", filePath.c_str());
         } else {
             file.deleteIt(true);
+            ConfigCache::invalidate(filePath);
         }
     }
 
@@ -68,6 +74,14 @@ public:
         returnType.addBool(); // success
     }
 
+    /**
+     * Define parameters.
+     */
+    void getParameterType(ServerInterface &srvInterface, SizedColumnTypes &parameterTypes) override
+    {
+        DFSUtil().addProfileParameter(parameterTypes);
+    }
+
     /**
      * Register the data type of outputs.
      */
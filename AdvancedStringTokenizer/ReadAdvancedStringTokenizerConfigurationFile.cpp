@@ -26,6 +26,7 @@ private:
     DFSFile file;
     DFSFileReader fileReader;
     DFSUtil dfsUtil = DFSUtil();
+    string filePath; // Path of DFS file for the selected profile
     map<string, string> parameters; // key-value pairs of parameter and value
 
 public:
@@ -35,9 +36,12 @@ public:
      */
     void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) override
     {
-        file = DFSFile(srvInterface, dfsUtil.FILE_PATH);
+        // Get the path of DFS file for the selected profile
+        filePath = dfsUtil.getFilePath(srvInterface);
+
+        file = DFSFile(srvInterface, filePath);
         if (!file.exists()) {
-            vt_report_error(0, "The DFS file [%s] does not exist", dfsUtil.FILE_PATH.c_str());
+            vt_report_error(0, "The DFS file [%s] does not exist", filePath.c_str());
         } else {
             fileReader = DFSFileReader(file);
             fileReader.open();
@@ -91,6 +95,14 @@ public:
         returnType.addVarchar(); // value
     }
 
+    /**
+     * Define parameters.
+     */
+    void getParameterType(ServerInterface &srvInterface, SizedColumnTypes &parameterTypes) override
+    {
+        DFSUtil().addProfileParameter(parameterTypes);
+    }
+
     /**
      * Register the data type of outputs.
      */
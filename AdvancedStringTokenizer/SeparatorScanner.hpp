@@ -0,0 +1,239 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: SeparatorScanner : Vectorized search for the major / minor separators
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef SEPARATOR_SCANNER_HPP
+#define SEPARATOR_SCANNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SEPARATOR_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * SeparatorScanner : Classify the characters with the configured separator sets and find the next separator
+ *
+ * The separator set is compiled into a 256-entry class table for the scalar path and into two nibble
+ * bitmaps for the SIMD paths. A byte b belongs to the set if bit (b >> 4) of bitmap[b & 0x0f] is set,
+ * which can be evaluated for 16 (SSE4.2) or 32 (AVX2) bytes at once with byte shuffles.
+ */
+class SeparatorScanner
+{
+
+public:
+    enum : uint8_t {
+        CLASS_NONE = 0,  // Not a separator
+        CLASS_MINOR = 1, // Minor separator
+        CLASS_MAJOR = 2, // Major separator (takes precedence over minor)
+        CLASS_LEAD = 3   // First byte of a multi-byte sequence which may be a separator
+    };
+
+    enum Kernel { KERNEL_AUTO, KERNEL_SCALAR, KERNEL_SSE42, KERNEL_AVX2 };
+
+    SeparatorScanner()
+    {
+        compile("", "");
+    }
+
+    /**
+     * Build the class table and the bitmaps from the separator lists.
+     * leadBytes lists the first bytes of multi-byte separators, which the caller has to decode and check.
+     */
+    void compile(const std::string &majorSeparators, const std::string &minorSeparators, const std::string &leadBytes = "")
+    {
+        memset(table, CLASS_NONE, sizeof(table));
+        for (size_t i = 0; i < leadBytes.size(); ++i) {
+            table[static_cast<unsigned char>(leadBytes[i])] = CLASS_LEAD;
+        }
+        for (size_t i = 0; i < minorSeparators.size(); ++i) {
+            table[static_cast<unsigned char>(minorSeparators[i])] = CLASS_MINOR;
+        }
+        for (size_t i = 0; i < majorSeparators.size(); ++i) {
+            table[static_cast<unsigned char>(majorSeparators[i])] = CLASS_MAJOR;
+        }
+
+        memset(bitmapLow, 0, sizeof(bitmapLow));
+        memset(bitmapHigh, 0, sizeof(bitmapHigh));
+        empty = true;
+        for (size_t c = 0; c < 256; ++c) {
+            if (table[c] != CLASS_NONE) {
+                if (c < 128) {
+                    bitmapLow[c & 0x0f] |= static_cast<uint8_t>(1 << (c >> 4));
+                } else {
+                    bitmapHigh[c & 0x0f] |= static_cast<uint8_t>(1 << ((c >> 4) - 8));
+                }
+                empty = false;
+            }
+        }
+
+        setKernel(KERNEL_AUTO);
+    }
+
+    /**
+     * Select the scanning kernel. KERNEL_AUTO picks the widest one supported by the CPU.
+     * Returns false if the requested kernel is not available.
+     */
+    bool setKernel(Kernel requested)
+    {
+        Kernel selected = (requested == KERNEL_AUTO) ? bestKernel() : requested;
+        if (!isSupported(selected)) {
+            return false;
+        }
+        kernel = selected;
+        return true;
+    }
+
+    Kernel getKernel() const
+    {
+        return kernel;
+    }
+
+    /**
+     * Check if the kernel can run on this CPU.
+     */
+    static bool isSupported(Kernel k)
+    {
+        switch (k) {
+        case KERNEL_AUTO:
+        case KERNEL_SCALAR:
+            return true;
+#ifdef SEPARATOR_SCANNER_X86
+        case KERNEL_SSE42:
+            return __builtin_cpu_supports("sse4.2");
+        case KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+        }
+    }
+
+    static const char *kernelName(Kernel k)
+    {
+        switch (k) {
+        case KERNEL_SCALAR:
+            return "scalar";
+        case KERNEL_SSE42:
+            return "sse4.2";
+        case KERNEL_AVX2:
+            return "avx2";
+        default:
+            return "auto";
+        }
+    }
+
+    /**
+     * Get the class of the character.
+     */
+    uint8_t classOf(char c) const
+    {
+        return table[static_cast<unsigned char>(c)];
+    }
+
+    /**
+     * Return the position of the first major or minor separator or lead byte in data[pos, len), or len if there is none.
+     */
+    size_t findNext(const char *data, size_t pos, size_t len) const
+    {
+        if (empty) {
+            return len;
+        }
+#ifdef SEPARATOR_SCANNER_X86
+        if (kernel == KERNEL_AVX2) {
+            return findNextAVX2(data, pos, len);
+        } else if (kernel == KERNEL_SSE42) {
+            return findNextSSE42(data, pos, len);
+        }
+#endif
+        return findNextScalar(data, pos, len);
+    }
+
+private:
+    uint8_t table[256];     // Class of each character
+    uint8_t bitmapLow[16];  // Bit h of bitmapLow[l] is set if (h << 4 | l) is a separator, h = 0..7
+    uint8_t bitmapHigh[16]; // Bit h of bitmapHigh[l] is set if ((h + 8) << 4 | l) is a separator, h = 0..7
+    bool empty = true;      // No separator is configured
+    Kernel kernel = KERNEL_SCALAR;
+
+    static Kernel bestKernel()
+    {
+        if (isSupported(KERNEL_AVX2)) {
+            return KERNEL_AVX2;
+        } else if (isSupported(KERNEL_SSE42)) {
+            return KERNEL_SSE42;
+        }
+        return KERNEL_SCALAR;
+    }
+
+    size_t findNextScalar(const char *data, size_t pos, size_t len) const
+    {
+        for ( ; pos < len; ++pos) {
+            if (table[static_cast<unsigned char>(data[pos])] != CLASS_NONE) {
+                return pos;
+            }
+        }
+        return len;
+    }
+
+#ifdef SEPARATOR_SCANNER_X86
+    __attribute__((target("sse4.2")))
+    size_t findNextSSE42(const char *data, size_t pos, size_t len) const
+    {
+        const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bitmapLow));
+        const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bitmapHigh));
+        const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        const __m128i nibble = _mm_set1_epi8(0x0f);
+        const __m128i zero = _mm_setzero_si128();
+
+        for ( ; pos + 16 <= len; pos += 16) {
+            __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+            __m128i lo = _mm_and_si128(in, nibble);
+            __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 4), nibble);
+            // pshufb yields zero for bytes with the top bit set, so the two halves are blended by that bit
+            __m128i row = _mm_blendv_epi8(_mm_shuffle_epi8(low, lo), _mm_shuffle_epi8(high, lo), in);
+            __m128i hit = _mm_and_si128(row, _mm_shuffle_epi8(bits, hi));
+            unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(hit, zero))) & 0xffffu;
+            if (mask != 0) {
+                return pos + __builtin_ctz(mask);
+            }
+        }
+        return findNextScalar(data, pos, len);
+    }
+
+    __attribute__((target("avx2")))
+    size_t findNextAVX2(const char *data, size_t pos, size_t len) const
+    {
+        const __m256i low = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bitmapLow)));
+        const __m256i high = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bitmapHigh)));
+        const __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                              1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        const __m256i nibble = _mm256_set1_epi8(0x0f);
+        const __m256i zero = _mm256_setzero_si256();
+
+        for ( ; pos + 32 <= len; pos += 32) {
+            __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+            __m256i lo = _mm256_and_si256(in, nibble);
+            __m256i hi = _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble);
+            __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(low, lo), _mm256_shuffle_epi8(high, lo), in);
+            __m256i hit = _mm256_and_si256(row, _mm256_shuffle_epi8(bits, hi));
+            unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hit, zero)));
+            if (mask != 0) {
+                return pos + __builtin_ctz(mask);
+            }
+        }
+        return findNextSSE42(data, pos, len);
+    }
+#endif
+};
+
+#endif // SEPARATOR_SCANNER_HPP
@@ -13,6 +13,7 @@
 #include "Vertica.h"
 #include "VerticaDFS.h"
 #include "DFSUtil.hpp"
+#include "ConfigCache.hpp"
 
 using namespace Vertica;
 using namespace std;
@@ -28,6 +29,7 @@ private:
     DFSFileWriter fileWriter;
     DFSFileReader fileReader;
     DFSUtil dfsUtil = DFSUtil();
+    string filePath; // Path of DFS file for the selected profile
     map<string, string> parameters;
 
 public:
@@ -37,15 +39,12 @@ public:
      */
     void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) override
     {
-        // Open DFS file
-        file = DFSFile(srvInterface, dfsUtil.FILE_PATH);
-        if (!file.exists()) { // If not exist, set default parameters
-            parameters.emplace(PARAM_STOPWORDSCASEINSENSITIVE, "");
-            parameters.emplace(PARAM_MINORSEPARATORS, "/:=@.-$#%\\_");
-            parameters.emplace(PARAM_MAJORSEPARATORS, " []<>(){}|!;,'\"*&?+\r\n\t");
-            parameters.emplace(PARAM_MINLENGTH, "2");
-            parameters.emplace(PARAM_MAXLENGTH, "128");
+        // Get the path of DFS file for the selected profile
+        filePath = dfsUtil.getFilePath(srvInterface);
 
+        // Open DFS file
+        file = DFSFile(srvInterface, filePath);
+        if (!file.exists()) { // If not exist, create it
             file.create(NS_GLOBAL, HINT_REPLICATE);
         } else { // Read the configuration parameters
             fileReader = DFSFileReader(file);
@@ -54,6 +53,11 @@ public:
             fileReader.close();
         }
 
+        // Set default parameters which are not in the file
+        for (const auto& x : defaultParameters()) {
+            parameters.emplace(x.first, x.second);
+        }
+
         fileWriter = DFSFileWriter(file);
         fileWriter.open();
     }
@@ -99,8 +103,17 @@ public:
             parameters.emplace(parameter, value.str());
         }
 
+        // Check that the parameters can be compiled
+        try {
+            TokenizerConfig config;
+            config.compile(parameters);
+        } catch (exception &e) {
+            vt_report_error(0, "Invalid value for parameter '%s': %s", parameter.c_str(), e.what());
+        }
+
         // Write input data into DFS file
         dfsUtil.writeParameters(srvInterface, fileWriter, parameters);
+        ConfigCache::invalidate(filePath);
         resWriter.setBool(true);
         resWriter.next();
     }
@@ -124,6 +137,14 @@ public:
         returnType.addBool();  // success
     }
 
+    /**
+     * Define parameters.
+     */
+    void getParameterType(ServerInterface &srvInterface, SizedColumnTypes &parameterTypes) override
+    {
+        DFSUtil().addProfileParameter(parameterTypes);
+    }
+
     /**
      * Register the data type of outputs.
      */
@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: StopWordMatcher : Case-insensitive stop word lookup without allocation
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef STOP_WORD_MATCHER_HPP
+#define STOP_WORD_MATCHER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * StopWordMatcher : Stop words compiled into an open-addressing table of case-folded words
+ *
+ * The tokens are hashed and compared directly on the input bytes, so no string is built per token.
+ * Lengths which no stop word has are rejected before hashing.
+ */
+class StopWordMatcher
+{
+
+public:
+    StopWordMatcher() {}
+
+    /**
+     * Compile the comma-separated list of stop words. Empty entries are ignored.
+     */
+    void compile(const std::string &stopWords)
+    {
+        pool.clear();
+        entries.clear();
+        slots.clear();
+        lengths.clear();
+        maxLength = 0;
+
+        size_t start = 0;
+        while (start <= stopWords.size()) {
+            size_t end = stopWords.find(',', start);
+            if (end == std::string::npos) {
+                end = stopWords.size();
+            }
+            if (end > start) {
+                Entry entry = {pool.size(), end - start};
+                for (size_t i = start; i < end; ++i) {
+                    pool += fold(stopWords[i]);
+                }
+                entries.push_back(entry);
+                if (maxLength < entry.length) {
+                    maxLength = entry.length;
+                }
+            }
+            start = end + 1;
+        }
+
+        // Keep the load factor at or below 0.5. Duplicated stop words are not inserted.
+        size_t capacity = 1;
+        while (capacity < entries.size() * 2) {
+            capacity <<= 1;
+        }
+        slots.assign(entries.empty() ? 0 : capacity, EMPTY_SLOT);
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const char *word = pool.data() + entries[i].offset;
+            if (!contains(word, entries[i].length)) {
+                size_t slot = hash(word, entries[i].length) & (slots.size() - 1);
+                while (slots[slot] != EMPTY_SLOT) {
+                    slot = (slot + 1) & (slots.size() - 1);
+                }
+                slots[slot] = static_cast<uint32_t>(i);
+            }
+        }
+
+        lengths.assign(maxLength + 1, false);
+        for (size_t i = 0; i < entries.size(); ++i) {
+            lengths[entries[i].length] = true;
+        }
+    }
+
+    bool empty() const
+    {
+        return entries.empty();
+    }
+
+    /**
+     * Check if the word is one of stop words.
+     */
+    bool isStopWord(const char *word, size_t length) const
+    {
+        if (length == 0 || length > maxLength || !lengths[length]) { // Also covers no stop words
+            return false;
+        }
+        return contains(word, length);
+    }
+
+private:
+    struct Entry {
+        size_t offset; // Offset of the folded word in pool
+        size_t length; // Length of the word
+    };
+
+    enum : uint32_t { EMPTY_SLOT = 0xffffffffu };
+
+    std::string pool;            // Concatenated case-folded stop words
+    std::vector<Entry> entries;  // Stop words in pool
+    std::vector<uint32_t> slots; // Open-addressing table of indexes to entries
+    std::vector<bool> lengths;   // Lengths which any stop word has
+    size_t maxLength = 0;        // Length of the longest stop word
+
+    static char fold(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    /**
+     * FNV-1a hash of the case-folded word.
+     */
+    static size_t hash(const char *word, size_t length)
+    {
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i = 0; i < length; ++i) {
+            h ^= static_cast<unsigned char>(fold(word[i]));
+            h *= 1099511628211ULL;
+        }
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+
+    bool contains(const char *word, size_t length) const
+    {
+        size_t slot = hash(word, length) & (slots.size() - 1);
+        while (slots[slot] != EMPTY_SLOT) {
+            if (equals(entries[slots[slot]], word, length)) {
+                return true;
+            }
+            slot = (slot + 1) & (slots.size() - 1);
+        }
+        return false;
+    }
+
+    bool equals(const Entry &entry, const char *word, size_t length) const
+    {
+        if (entry.length != length) {
+            return false;
+        }
+        const char *folded = pool.data() + entry.offset;
+        for (size_t i = 0; i < length; ++i) {
+            if (folded[i] != fold(word[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+#endif // STOP_WORD_MATCHER_HPP
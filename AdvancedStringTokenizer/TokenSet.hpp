@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: TokenSet : Reusable set of tokens to emit each distinct token once per row
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef TOKEN_SET_HPP
+#define TOKEN_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * TokenSet : Open-addressing set of spans in the current input row
+ *
+ * The spans point into the input, so no token is copied. clear() only advances the generation number,
+ * and the table is reallocated only when a row has more distinct tokens than any row before.
+ */
+class TokenSet
+{
+
+public:
+    TokenSet() : slots(64) {}
+
+    /**
+     * Forget all tokens in O(1).
+     */
+    void clear()
+    {
+        size = 0;
+        if (++generation == 0) { // Wrapped around, so old stamps could look current
+            for (size_t i = 0; i < slots.size(); ++i) {
+                slots[i].generation = 0;
+            }
+            generation = 1;
+        }
+    }
+
+    /**
+     * Insert the token with its hash. Returns false if the token is already in the set.
+     */
+    bool insert(const char *word, size_t length, uint64_t hash)
+    {
+        if ((size + 1) * 2 > slots.size()) {
+            grow();
+        }
+        size_t mask = slots.size() - 1;
+        for (size_t i = static_cast<size_t>(hash) & mask; ; i = (i + 1) & mask) {
+            Slot &slot = slots[i];
+            if (slot.generation != generation) {
+                slot.generation = generation;
+                slot.hash = hash;
+                slot.word = word;
+                slot.length = length;
+                ++size;
+                return true;
+            }
+            if (slot.hash == hash && slot.length == length && memcmp(slot.word, word, length) == 0) {
+                return false;
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        uint32_t generation = 0; // Slot is used in the current row if it equals the generation of the set
+        uint64_t hash = 0;
+        const char *word = nullptr;
+        size_t length = 0;
+    };
+
+    std::vector<Slot> slots;
+    size_t size = 0;         // Number of tokens in the current row
+    uint32_t generation = 1; // Generation of the current row
+
+    void grow()
+    {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.resize(old.size() * 2);
+        size_t mask = slots.size() - 1;
+        for (size_t i = 0; i < old.size(); ++i) {
+            if (old[i].generation == generation) {
+                size_t j = static_cast<size_t>(old[i].hash) & mask;
+                while (slots[j].generation == generation) {
+                    j = (j + 1) & mask;
+                }
+                slots[j] = old[i];
+            }
+        }
+    }
+};
+
+#endif // TOKEN_SET_HPP
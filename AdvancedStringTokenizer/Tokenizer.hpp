@@ -0,0 +1,304 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Tokenizer : Core of AdvancedStringTokenizer independent of the Vertica SDK
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef TOKENIZER_HPP
+#define TOKENIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "TokenSet.hpp"
+#include "TokenizerConfig.hpp"
+#include "WorkerPool.hpp"
+
+/**
+ * Tokenizer : Separate a text into the tokens using the major and minor separators
+ *
+ * The tokens are filtered on the input spans, so only the surviving tokens are passed to the emitter.
+ */
+class Tokenizer
+{
+
+public:
+    std::shared_ptr<const TokenizerConfig> config = std::make_shared<TokenizerConfig>();
+
+    /**
+     * Tokenize the text and call emit(const char *word, size_t length) for each surviving token.
+     * A text longer than the parallel threshold is tokenized by the worker threads, but emit is always
+     * called on this thread in the same order.
+     */
+    template <typename Emit>
+    void tokenize(const char *sentenceData, size_t sentenseLength, Emit &&emit)
+    {
+        if (config->uniqueTokens) {
+            rowTokens.clear();
+        }
+        if (config->parallelThreads > 1 && config->parallelThreshold > 0 && sentenseLength >= config->parallelThreshold
+            && tokenizeParallel(sentenceData, sentenseLength, emit)) {
+            return;
+        }
+        tokenizeSerial(sentenceData, sentenseLength, emit);
+    }
+
+    /**
+     * 64-bit FNV-1a hash of the token, which is stable across platforms and versions.
+     */
+    static uint64_t hashToken(const char *word, size_t length)
+    {
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i = 0; i < length; ++i) {
+            h ^= static_cast<unsigned char>(word[i]);
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    /**
+     * Get the number of tokens dropped by the length, stop word or duplicate filter, and reset it.
+     */
+    size_t takeFilteredTokens()
+    {
+        size_t count = filteredTokens;
+        filteredTokens = 0;
+        return count;
+    }
+
+    /**
+     * Stop the threads of parallel tokenization and free the buffers of the chunks.
+     */
+    void releaseThreads()
+    {
+        pool.reset();
+        chunkTokenizers.clear();
+    }
+
+private:
+    bool prevCharMajorSep = false;  // Flag to indicate the previous character is major separator
+    bool prevCharMinorSep = false;  // Flag to indicate the previous character is minor separator
+    size_t filteredTokens = 0;      // Number of tokens dropped by the filters
+    std::vector<size_t> boundaries; // Character boundaries of the token for the n-grams in UTF-8 mode
+    TokenSet rowTokens;             // Tokens emitted for the current row when uniqueTokens is set
+    std::unique_ptr<WorkerPool> pool; // Threads to tokenize a large text, started on the first large text
+    std::vector<std::unique_ptr<Tokenizer>> chunkTokenizers;               // Tokenizer of each chunk
+    std::vector<std::vector<std::pair<const char *, size_t>>> chunkTokens; // Tokens of each chunk
+    std::vector<size_t> chunkStarts;                                       // Start position of each chunk
+
+    /**
+     * Tokenize the text on this thread.
+     */
+    template <typename Emit>
+    void tokenizeSerial(const char *sentenceData, size_t sentenseLength, Emit &emit)
+    {
+        const SeparatorScanner &scanner = config->scanner;
+        size_t wordStart = 0, wordEnd = 0, wordMinorStart = 0;
+        bool majorFlag = false, minorFlag = false;
+
+        while (wordEnd < sentenseLength) {
+            // Skip reading the characters until major/minor separator appears
+            size_t sepPos = wordEnd, sepWidth = 1;
+            uint8_t sepClass = SeparatorScanner::CLASS_NONE;
+            while ((sepPos = scanner.findNext(sentenceData, sepPos, sentenseLength)) < sentenseLength) {
+                sepClass = scanner.classOf(sentenceData[sepPos]);
+                if (sepClass != SeparatorScanner::CLASS_LEAD) {
+                    break;
+                }
+                // Multi-byte character in UTF-8 mode, which may or may not be a separator
+                sepClass = config->classOfCodePoint(sentenceData, sepPos, sentenseLength, sepWidth);
+                if (sepClass != SeparatorScanner::CLASS_NONE) {
+                    break;
+                }
+                sepPos += sepWidth;
+                sepWidth = 1;
+            }
+            if (sepPos != wordEnd) {
+                prevCharMajorSep = false;
+                prevCharMinorSep = false;
+                wordEnd = sepPos;
+            }
+            if (wordEnd < sentenseLength) {
+                if (sepClass == SeparatorScanner::CLASS_MAJOR) {
+                    majorFlag = true;
+                } else {
+                    prevCharMajorSep = false;
+                    minorFlag = true;
+                }
+            }
+
+            // Create a token using minor separator
+            if (minorFlag || wordStart != wordMinorStart) {
+                if (!prevCharMajorSep && !prevCharMinorSep) {
+                    filter(&sentenceData[wordMinorStart], wordEnd - wordMinorStart, false, emit);
+                }
+
+                wordMinorStart = wordEnd + sepWidth;
+                prevCharMinorSep = true;
+                minorFlag = false;
+            }
+
+            // Create a token using major separator
+            if (majorFlag || sentenseLength == wordEnd || sentenseLength == wordMinorStart) {
+                if (!majorFlag && sentenseLength == wordMinorStart) {
+                    wordEnd += sepWidth;
+                }
+                if (!prevCharMajorSep) {
+                    filter(&sentenceData[wordStart], wordEnd - wordStart, true, emit);
+                }
+
+                wordStart = wordEnd + sepWidth;
+                wordMinorStart = wordStart;
+                prevCharMajorSep = true;
+                majorFlag = false;
+            }
+
+            wordEnd += sepWidth;
+        }
+    }
+
+    /**
+     * Split the text into chunks at major separators, tokenize them in parallel and emit the tokens in order.
+     * Returns false without emitting anything if the text cannot be split.
+     *
+     * A chunk ends with a single-byte major separator followed by a character which is not a separator,
+     * so the separator flags are reset at the start of every chunk except the first, as in the serial scan.
+     */
+    template <typename Emit>
+    bool tokenizeParallel(const char *sentenceData, size_t sentenseLength, Emit &emit)
+    {
+        const SeparatorScanner &scanner = config->scanner;
+        const size_t numThreads = config->parallelThreads;
+        chunkStarts.assign(1, 0);
+        for (size_t k = 1; k < numThreads; ++k) {
+            size_t pos = sentenseLength / numThreads * k;
+            if (pos < chunkStarts.back()) {
+                pos = chunkStarts.back();
+            }
+            while ((pos = scanner.findNext(sentenceData, pos, sentenseLength)) + 1 < sentenseLength
+                   && !(scanner.classOf(sentenceData[pos]) == SeparatorScanner::CLASS_MAJOR
+                        && scanner.classOf(sentenceData[pos + 1]) == SeparatorScanner::CLASS_NONE)) {
+                ++pos;
+            }
+            if (pos + 1 >= sentenseLength) { // No more split point
+                break;
+            }
+            chunkStarts.push_back(pos + 1);
+        }
+        const size_t numChunks = chunkStarts.size();
+        if (numChunks < 2) {
+            return false;
+        }
+
+        if (!pool || pool->size() != numThreads) {
+            pool.reset(new WorkerPool(numThreads));
+        }
+        while (chunkTokenizers.size() < numChunks) {
+            chunkTokenizers.emplace_back(new Tokenizer());
+        }
+        chunkTokens.resize(numChunks);
+        for (size_t i = 0; i < numChunks; ++i) {
+            chunkTokenizers[i]->config = config;
+            chunkTokens[i].clear();
+        }
+        chunkTokenizers[0]->prevCharMajorSep = prevCharMajorSep;
+        chunkTokenizers[0]->prevCharMinorSep = prevCharMinorSep;
+
+        pool->run(numChunks, [&](size_t i) {
+            Tokenizer &chunkTokenizer = *chunkTokenizers[i];
+            std::vector<std::pair<const char *, size_t>> &tokens = chunkTokens[i];
+            size_t start = chunkStarts[i];
+            size_t end = (i + 1 < numChunks) ? chunkStarts[i + 1] : sentenseLength;
+            auto collect = [&tokens](const char *word, size_t length) { tokens.push_back(std::make_pair(word, length)); };
+            if (config->uniqueTokens) {
+                chunkTokenizer.rowTokens.clear();
+            }
+            chunkTokenizer.tokenizeSerial(sentenceData + start, end - start, collect);
+        });
+
+        // Merge the tokens in order. The duplicates across the chunks are removed here.
+        for (size_t i = 0; i < numChunks; ++i) {
+            filteredTokens += chunkTokenizers[i]->takeFilteredTokens();
+            for (const std::pair<const char *, size_t> &token : chunkTokens[i]) {
+                emitUnique(token.first, token.second, emit);
+            }
+        }
+        prevCharMajorSep = chunkTokenizers[numChunks - 1]->prevCharMajorSep;
+        prevCharMinorSep = chunkTokenizers[numChunks - 1]->prevCharMinorSep;
+        return true;
+    }
+
+    /**
+     * Apply the length and stop word filters to the token, truncate it, and emit it if it survives.
+     * The n-grams of a surviving major token are emitted after the token.
+     */
+    template <typename Emit>
+    void filter(const char *word, size_t length, bool major, Emit &emit)
+    {
+        if (length < config->minLength) {
+            ++filteredTokens;
+            return;
+        }
+        size_t outputLength = length;
+        if (outputLength > config->maxLength) {
+            outputLength = config->utf8 ? Utf8::truncate(word, length, config->maxLength) : config->maxLength;
+        }
+        if (config->stopWords.isStopWord(word, outputLength)) {
+            ++filteredTokens;
+            return;
+        }
+        emitUnique(word, outputLength, emit);
+
+        if (major && config->ngramLength > 0) { // Bounded by maxLength, so a huge token emits a bounded number of n-grams
+            emitNgrams(word, outputLength, emit);
+        }
+    }
+
+    /**
+     * Emit the token unless the same token has already been emitted for the row when uniqueTokens is set.
+     */
+    template <typename Emit>
+    void emitUnique(const char *word, size_t length, Emit &emit)
+    {
+        if (config->uniqueTokens && !rowTokens.insert(word, length, hashToken(word, length))) {
+            ++filteredTokens;
+            return;
+        }
+        emit(word, length);
+    }
+
+    /**
+     * Emit the character n-grams of the truncated token. A token which is not longer than the n-gram length
+     * is already emitted as it is.
+     */
+    template <typename Emit>
+    void emitNgrams(const char *word, size_t length, Emit &emit)
+    {
+        const size_t n = config->ngramLength;
+        if (!config->utf8) {
+            for (size_t i = 0; n < length && i + n <= length; ++i) {
+                emitUnique(word + i, n, emit);
+            }
+            return;
+        }
+
+        boundaries.clear();
+        for (size_t i = 0; i < length; i += Utf8::sequenceLength(static_cast<unsigned char>(word[i]))) {
+            boundaries.push_back(i);
+        }
+        boundaries.push_back(length);
+        const size_t numChars = boundaries.size() - 1;
+        for (size_t i = 0; n < numChars && i + n <= numChars; ++i) {
+            size_t end = boundaries[i + n] < length ? boundaries[i + n] : length;
+            emitUnique(word + boundaries[i], end - boundaries[i], emit);
+        }
+    }
+};
+
+#endif // TOKENIZER_HPP
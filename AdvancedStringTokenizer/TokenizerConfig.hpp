@@ -0,0 +1,223 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: TokenizerConfig : Compiled configuration parameters of AdvancedStringTokenizer
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef TOKENIZER_CONFIG_HPP
+#define TOKENIZER_CONFIG_HPP
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "SeparatorScanner.hpp"
+#include "StopWordMatcher.hpp"
+#include "Utf8.hpp"
+
+const std::string PARAM_STOPWORDSCASEINSENSITIVE = "stopwordscaseinsensitive";
+const std::string PARAM_MINORSEPARATORS = "minorseparators";
+const std::string PARAM_MAJORSEPARATORS = "majorseparators";
+const std::string PARAM_MINLENGTH = "minlength";
+const std::string PARAM_MAXLENGTH = "maxlength";
+const std::string PARAM_UTF8MODE = "utf8mode";
+const std::string PARAM_UNICODESEPARATORS = "unicodeseparators";
+const std::string PARAM_NGRAMLENGTH = "ngramlength";
+const std::string PARAM_UNIQUETOKENS = "uniquetokens";
+const std::string PARAM_PARALLELTHRESHOLD = "parallelthreshold";
+const std::string PARAM_PARALLELTHREADS = "parallelthreads";
+
+/**
+ * Get the default configuration parameters.
+ */
+inline std::map<std::string, std::string> defaultParameters()
+{
+    return {
+        {PARAM_STOPWORDSCASEINSENSITIVE, ""},
+        {PARAM_MINORSEPARATORS, "/:=@.-$#%\\_"},
+        {PARAM_MAJORSEPARATORS, " []<>(){}|!;,'\"*&?+\r\n\t"},
+        {PARAM_MINLENGTH, "2"},
+        {PARAM_MAXLENGTH, "128"},
+        {PARAM_UTF8MODE, "false"},
+        {PARAM_UNICODESEPARATORS, ""},
+        {PARAM_NGRAMLENGTH, "0"},
+        {PARAM_UNIQUETOKENS, "false"},
+        {PARAM_PARALLELTHRESHOLD, "1048576"},
+        {PARAM_PARALLELTHREADS, "1"}
+    };
+}
+
+/**
+ * TokenizerConfig : Configuration parameters compiled into the structures used by Tokenizer
+ *
+ * A compiled configuration is immutable once it is published, so it can be shared by all instances.
+ * compile() throws std::invalid_argument for an invalid value.
+ */
+struct TokenizerConfig
+{
+    SeparatorScanner scanner;           // Compiled major / minor separators
+    StopWordMatcher stopWords;          // Compiled stop words
+    size_t minLength = 0;               // Min length of token
+    size_t maxLength = SIZE_MAX;        // Max length of token
+    size_t ngramLength = 0;             // Length of character n-grams emitted for each major token, 0 to disable
+    bool uniqueTokens = false;          // Emit each distinct token at most once per input row
+    size_t parallelThreshold = 0;       // Min length of input which is tokenized in parallel, 0 to disable
+    size_t parallelThreads = 1;         // Number of threads to tokenize a large input, 1 to disable
+    bool utf8 = false;                  // Separators are UTF-8 characters and tokens are truncated on character boundaries
+    Utf8::CodePointSet majorCodePoints; // Non-ASCII major separators in UTF-8 mode
+    Utf8::CodePointSet minorCodePoints; // Non-ASCII minor separators in UTF-8 mode
+    std::bitset<65536> prefixes;        // First two bytes of the non-ASCII separators in UTF-8 mode
+    uint64_t version = 0;               // Version assigned by the cache when compiled
+
+    /**
+     * Compile the key-value pairs of parameter and value.
+     */
+    void compile(const std::map<std::string, std::string> &parameters)
+    {
+        std::string minorSeparators = "";   // Minor separators
+        std::string majorSeparators = "";   // Major separetors
+        std::string unicodeSeparators = ""; // Unicode separator classes
+        for (const auto& x : parameters) {
+            if (x.first == PARAM_STOPWORDSCASEINSENSITIVE) { // stopwordscaseinsensitive
+                stopWords.compile(x.second);
+            } else if (x.first == PARAM_MINORSEPARATORS) { // minorseparators
+                minorSeparators = x.second;
+            } else if (x.first == PARAM_MAJORSEPARATORS) { // majorseparators
+                majorSeparators = x.second;
+            } else if (x.first == PARAM_MINLENGTH) { // minlength
+                minLength = std::stoul(x.second, nullptr, 10);
+            } else if (x.first == PARAM_MAXLENGTH) { // maxlength
+                maxLength = std::stoul(x.second, nullptr, 10);
+            } else if (x.first == PARAM_NGRAMLENGTH) { // ngramlength
+                ngramLength = std::stoul(x.second, nullptr, 10);
+            } else if (x.first == PARAM_UNIQUETOKENS) { // uniquetokens
+                uniqueTokens = parseBool(x.first, x.second);
+            } else if (x.first == PARAM_PARALLELTHRESHOLD) { // parallelthreshold
+                parallelThreshold = std::stoul(x.second, nullptr, 10);
+            } else if (x.first == PARAM_PARALLELTHREADS) { // parallelthreads
+                parallelThreads = std::stoul(x.second, nullptr, 10);
+                if (parallelThreads > 64) {
+                    throw std::invalid_argument("Invalid value '" + x.second + "' for parameter '" + PARAM_PARALLELTHREADS
+                                                + "'; the value must be between 0 and 64.");
+                }
+                if (parallelThreads == 0) { // Number of hardware threads, up to 8
+                    parallelThreads = std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+                }
+            } else if (x.first == PARAM_UTF8MODE) { // utf8mode
+                utf8 = parseBool(x.first, x.second);
+            } else if (x.first == PARAM_UNICODESEPARATORS) { // unicodeseparators
+                unicodeSeparators = x.second;
+            }
+        }
+
+        if (!utf8) {
+            scanner.compile(majorSeparators, minorSeparators);
+            return;
+        }
+
+        // In UTF-8 mode, ASCII separators stay in the byte table and the others are looked up by code point
+        std::string majorBytes, minorBytes, leadBytes;
+        splitSeparators(majorSeparators, majorBytes, majorCodePoints);
+        splitSeparators(minorSeparators, minorBytes, minorCodePoints);
+        size_t start = 0;
+        while (start <= unicodeSeparators.size()) {
+            size_t end = unicodeSeparators.find(',', start);
+            if (end == std::string::npos) {
+                end = unicodeSeparators.size();
+            }
+            std::string name = unicodeSeparators.substr(start, end - start);
+            if (name == "whitespace") {
+                majorCodePoints.add(Utf8::whitespace());
+            } else if (name == "punctuation") {
+                majorCodePoints.add(Utf8::punctuation());
+            } else if (!name.empty()) {
+                throw std::invalid_argument("Invalid value '" + name + "' for parameter '" + PARAM_UNICODESEPARATORS
+                                            + "'; the value must be a comma-separated list of whitespace and punctuation.");
+            }
+            start = end + 1;
+        }
+        majorCodePoints.build();
+        minorCodePoints.build();
+
+        bool leads[256] = {};
+        for (const Utf8::CodePointSet *set : {&majorCodePoints, &minorCodePoints}) {
+            for (const Utf8::Range &range : set->getRanges()) {
+                for (uint32_t cp = range.first; cp <= range.second; ++cp) {
+                    uint16_t prefix = Utf8::prefix(cp);
+                    prefixes.set(prefix);
+                    leads[prefix >> 8] = true;
+                }
+            }
+        }
+        for (size_t c = 0x80; c < 256; ++c) {
+            if (leads[c]) {
+                leadBytes += static_cast<char>(c);
+            }
+        }
+        scanner.compile(majorBytes, minorBytes, leadBytes);
+    }
+
+    /**
+     * Classify the multi-byte character at data[pos], whose first byte is a lead byte of the scanner.
+     * width is set to the number of bytes of the character.
+     */
+    uint8_t classOfCodePoint(const char *data, size_t pos, size_t len, size_t &width) const
+    {
+        // Most characters sharing the lead byte with a separator are rejected by the first two bytes.
+        // Continuation bytes are never separators, so the scan can simply resume at the next byte.
+        if (pos + 1 < len && !prefixes.test(static_cast<unsigned char>(data[pos]) << 8 | static_cast<unsigned char>(data[pos + 1]))) {
+            width = 1;
+            return SeparatorScanner::CLASS_NONE;
+        }
+
+        uint32_t cp = Utf8::decode(data, pos, len, width);
+        if (cp == Utf8::INVALID) {
+            return SeparatorScanner::CLASS_NONE;
+        } else if (majorCodePoints.contains(cp)) {
+            return SeparatorScanner::CLASS_MAJOR;
+        } else if (minorCodePoints.contains(cp)) {
+            return SeparatorScanner::CLASS_MINOR;
+        }
+        return SeparatorScanner::CLASS_NONE;
+    }
+
+    static bool parseBool(const std::string &name, const std::string &value)
+    {
+        if (value == "true" || value == "1") {
+            return true;
+        } else if (value == "false" || value == "0" || value.empty()) {
+            return false;
+        }
+        throw std::invalid_argument("Invalid value '" + value + "' for parameter '" + name + "'; the value must be true or false.");
+    }
+
+private:
+    /**
+     * Split the separator list into ASCII bytes and non-ASCII code points.
+     */
+    static void splitSeparators(const std::string &separators, std::string &bytes, Utf8::CodePointSet &codePoints)
+    {
+        size_t pos = 0, width = 1;
+        while (pos < separators.size()) {
+            uint32_t cp = Utf8::decode(separators.data(), pos, separators.size(), width);
+            if (cp == Utf8::INVALID) {
+                throw std::invalid_argument("Invalid UTF-8 sequence in the separators");
+            } else if (cp < 0x80) {
+                bytes += static_cast<char>(cp);
+            } else {
+                codePoints.add(cp, cp);
+            }
+            pos += width;
+        }
+    }
+};
+
+#endif // TOKENIZER_CONFIG_HPP
@@ -0,0 +1,189 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Utf8 : UTF-8 decoding and Unicode separator classes for AdvancedStringTokenizer
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef UTF8_HPP
+#define UTF8_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Utf8
+{
+
+const uint32_t INVALID = 0xffffffffu;
+
+/**
+ * Decode the code point at data[pos]. width is set to the number of bytes consumed, which is 1 for an invalid sequence.
+ */
+inline uint32_t decode(const char *data, size_t pos, size_t len, size_t &width)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data + pos);
+    size_t avail = len - pos;
+    width = 1;
+    if (p[0] < 0x80) {
+        return p[0];
+    }
+
+    uint32_t cp, min;
+    size_t n;
+    if ((p[0] & 0xe0) == 0xc0) {
+        cp = p[0] & 0x1f; n = 2; min = 0x80;
+    } else if ((p[0] & 0xf0) == 0xe0) {
+        cp = p[0] & 0x0f; n = 3; min = 0x800;
+    } else if ((p[0] & 0xf8) == 0xf0) {
+        cp = p[0] & 0x07; n = 4; min = 0x10000;
+    } else {
+        return INVALID;
+    }
+    if (avail < n) {
+        return INVALID;
+    }
+    for (size_t i = 1; i < n; ++i) {
+        if ((p[i] & 0xc0) != 0x80) {
+            return INVALID;
+        }
+        cp = (cp << 6) | (p[i] & 0x3f);
+    }
+    if (cp < min || cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff)) {
+        return INVALID;
+    }
+    width = n;
+    return cp;
+}
+
+/**
+ * Get the first two bytes of the UTF-8 encoding of the non-ASCII code point as a 16-bit value.
+ */
+inline uint16_t prefix(uint32_t cp)
+{
+    if (cp < 0x800) {
+        return static_cast<uint16_t>((0xc0 | (cp >> 6)) << 8 | (0x80 | (cp & 0x3f)));
+    } else if (cp < 0x10000) {
+        return static_cast<uint16_t>((0xe0 | (cp >> 12)) << 8 | (0x80 | ((cp >> 6) & 0x3f)));
+    }
+    return static_cast<uint16_t>((0xf0 | (cp >> 18)) << 8 | (0x80 | ((cp >> 12) & 0x3f)));
+}
+
+/**
+ * Get the number of bytes of the character starting with the byte. Continuation and invalid bytes count as 1.
+ */
+inline size_t sequenceLength(unsigned char c)
+{
+    if (c >= 0xf0 && c < 0xf8) {
+        return 4;
+    } else if (c >= 0xe0 && c < 0xf0) {
+        return 3;
+    } else if (c >= 0xc0 && c < 0xe0) {
+        return 2;
+    }
+    return 1;
+}
+
+/**
+ * Shorten the length so that the string does not end in the middle of a multi-byte sequence.
+ */
+inline size_t truncate(const char *data, size_t length, size_t maxLength)
+{
+    if (length <= maxLength) {
+        return length;
+    }
+    length = maxLength;
+    while (length > 0 && (static_cast<unsigned char>(data[length]) & 0xc0) == 0x80) {
+        --length;
+    }
+    return length;
+}
+
+typedef std::pair<uint32_t, uint32_t> Range; // Inclusive range of code points
+
+/**
+ * Non-ASCII code points with the White_Space property.
+ */
+inline const std::vector<Range> &whitespace()
+{
+    static const std::vector<Range> ranges = {
+        {0x0085, 0x0085}, {0x00a0, 0x00a0}, {0x1680, 0x1680}, {0x2000, 0x200a}, {0x2028, 0x2029},
+        {0x202f, 0x202f}, {0x205f, 0x205f}, {0x3000, 0x3000}
+    };
+    return ranges;
+}
+
+/**
+ * Non-ASCII punctuation in Latin-1 Supplement, General Punctuation, CJK Symbols and Punctuation,
+ * and Halfwidth and Fullwidth Forms.
+ */
+inline const std::vector<Range> &punctuation()
+{
+    static const std::vector<Range> ranges = {
+        {0x00a1, 0x00a1}, {0x00a7, 0x00a7}, {0x00ab, 0x00ab}, {0x00b6, 0x00b7}, {0x00bb, 0x00bb},
+        {0x00bf, 0x00bf}, {0x2010, 0x2027}, {0x2030, 0x2043}, {0x2045, 0x2051}, {0x2053, 0x205e},
+        {0x3001, 0x3003}, {0x3008, 0x3011}, {0x3014, 0x301f}, {0x3030, 0x3030}, {0x303d, 0x303d},
+        {0x30fb, 0x30fb}, {0xff01, 0xff03}, {0xff05, 0xff0a}, {0xff0c, 0xff0f}, {0xff1a, 0xff1b},
+        {0xff1f, 0xff20}, {0xff3b, 0xff3d}, {0xff3f, 0xff3f}, {0xff5b, 0xff5b}, {0xff5d, 0xff5d},
+        {0xff5f, 0xff65}
+    };
+    return ranges;
+}
+
+/**
+ * CodePointSet : Sorted set of non-overlapping code point ranges
+ */
+class CodePointSet
+{
+
+public:
+    void add(uint32_t lo, uint32_t hi)
+    {
+        ranges.push_back(Range(lo, hi));
+    }
+
+    void add(const std::vector<Range> &other)
+    {
+        ranges.insert(ranges.end(), other.begin(), other.end());
+    }
+
+    /**
+     * Sort and merge the ranges. Must be called after adding and before looking up.
+     */
+    void build()
+    {
+        std::sort(ranges.begin(), ranges.end());
+        std::vector<Range> merged;
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            if (!merged.empty() && ranges[i].first <= merged.back().second + 1) {
+                merged.back().second = std::max(merged.back().second, ranges[i].second);
+            } else {
+                merged.push_back(ranges[i]);
+            }
+        }
+        ranges.swap(merged);
+    }
+
+    bool contains(uint32_t cp) const
+    {
+        std::vector<Range>::const_iterator it = std::upper_bound(ranges.begin(), ranges.end(), Range(cp, 0xffffffffu));
+        return it != ranges.begin() && (--it)->second >= cp;
+    }
+
+    const std::vector<Range> &getRanges() const
+    {
+        return ranges;
+    }
+
+private:
+    std::vector<Range> ranges;
+};
+
+} // namespace Utf8
+
+#endif // UTF8_HPP
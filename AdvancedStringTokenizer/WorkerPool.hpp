@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: WorkerPool : Fixed set of threads to tokenize the chunks of a large input in parallel
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * WorkerPool : Run the numbered tasks on the worker threads and the calling thread
+ *
+ * The threads are started once and wait for the next batch, so no thread is created per row.
+ * The tasks must not call the Vertica SDK, which is only allowed on the calling thread.
+ */
+class WorkerPool
+{
+
+public:
+    explicit WorkerPool(size_t numThreads)
+    {
+        for (size_t i = 1; i < numThreads; ++i) { // The calling thread is one of them
+            threads.emplace_back(&WorkerPool::work, this);
+        }
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    size_t size() const
+    {
+        return threads.size() + 1;
+    }
+
+    /**
+     * Call task(i) for i in [0, numTasks) and wait until all of them finish.
+     */
+    void run(size_t numTasks, const std::function<void(size_t)> &task)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        current = &task;
+        total = numTasks;
+        nextTask = 0;
+        running = 0;
+        ++batch;
+        wakeUp.notify_all();
+
+        runTasks(lock);
+        finished.wait(lock, [this] { return nextTask >= total && running == 0; });
+        current = nullptr;
+    }
+
+private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wakeUp;   // Notified when a batch is submitted or the pool is stopping
+    std::condition_variable finished; // Notified when the last task of a batch finishes
+    const std::function<void(size_t)> *current = nullptr; // Task of the current batch
+    size_t total = 0;    // Number of tasks in the current batch
+    size_t nextTask = 0; // Next task to be taken
+    size_t running = 0;  // Number of tasks being run
+    size_t batch = 0;    // Sequence number of the batch
+    bool stopping = false;
+
+    /**
+     * Take and run the tasks of the current batch until none is left. The lock is released while a task runs.
+     */
+    void runTasks(std::unique_lock<std::mutex> &lock)
+    {
+        while (nextTask < total) {
+            size_t i = nextTask++;
+            ++running;
+            lock.unlock();
+            (*current)(i);
+            lock.lock();
+            if (--running == 0 && nextTask >= total) {
+                finished.notify_all();
+            }
+        }
+    }
+
+    void work()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        size_t seen = 0;
+        while (true) {
+            wakeUp.wait(lock, [&] { return stopping || batch != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = batch;
+            runTasks(lock);
+        }
+    }
+};
+
+#endif // WORKER_POOL_HPP
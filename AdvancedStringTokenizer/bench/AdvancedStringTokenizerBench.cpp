@@ -0,0 +1,269 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Offline benchmark of AdvancedStringTokenizer over a local log corpus file
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <new>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../Tokenizer.hpp"
+
+using namespace std;
+
+// Number of allocations made by operator new in this process
+static atomic<size_t> allocations(0);
+
+// GCC pairs the inlined new-expressions with the free() below, and warns that they do not match
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(size_t size)
+{
+    ++allocations;
+    void *p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+/**
+ * BenchReader : Stand-in for PartitionReader which returns one line of the corpus as the text of each row
+ */
+class BenchReader
+{
+
+public:
+    explicit BenchReader(const string &corpus) : corpus(corpus) {}
+
+    void rewind()
+    {
+        rowStart = 0;
+        rowEnd = corpus.find('\n');
+        if (rowEnd == string::npos) {
+            rowEnd = corpus.size();
+        }
+        id = 1;
+    }
+
+    bool next()
+    {
+        if (rowEnd >= corpus.size()) {
+            return false;
+        }
+        rowStart = rowEnd + 1;
+        rowEnd = corpus.find('\n', rowStart);
+        if (rowEnd == string::npos) {
+            rowEnd = corpus.size();
+        }
+        ++id;
+        return true;
+    }
+
+    int64_t getId() const { return id; }
+    const char *data() const { return corpus.data() + rowStart; }
+    size_t length() const { return rowEnd - rowStart; }
+
+private:
+    const string &corpus;
+    size_t rowStart = 0;
+    size_t rowEnd = 0;
+    int64_t id = 1;
+};
+
+/**
+ * BenchWriter : Stand-in for PartitionWriter which copies each token and doc_id into a fixed output row
+ */
+class BenchWriter
+{
+
+public:
+    explicit BenchWriter(size_t maxTokenLength) : token(maxTokenLength) {}
+
+    void setToken(const char *data, size_t length)
+    {
+        memcpy(token.data(), data, length);
+        tokenLength = length;
+    }
+
+    void setId(int64_t value) { id = value; }
+
+    void next()
+    {
+        ++rows;
+        bytes += tokenLength;
+    }
+
+    size_t rows = 0;  // Number of output rows
+    size_t bytes = 0; // Total length of tokens
+
+private:
+    vector<char> token;
+    size_t tokenLength = 0;
+    int64_t id = 0;
+};
+
+/**
+ * Read the file into the string.
+ */
+static bool readFile(const char *path, string &contents)
+{
+    ifstream in(path, ios::binary);
+    if (!in) {
+        return false;
+    }
+    stringstream ss;
+    ss << in.rdbuf();
+    contents = ss.str();
+    return true;
+}
+
+/**
+ * Check the tokens of the example in README.md with the default configuration parameters.
+ */
+static bool checkGolden()
+{
+    const string sentence = "2014-05-10 00:00:05.700433 %ASA-6-302013: Built outbound TCP connection 9986454 for "
+                            "outside:101.123.123.111/443 (101.123.123.111/443)";
+    // Rows of idx_log in README.md, where the duplicated tokens are stored once
+    const set<string> expected = {
+        "%ASA-6-302013:", "00", "00:00:05.700433", "05", "10", "101", "101.123.123.111/443", "111", "123", "2014",
+        "2014-05-10", "302013", "443", "700433", "9986454", "ASA", "Built", "TCP", "connection", "for", "outbound",
+        "outside", "outside:101.123.123.111/443"
+    };
+    const size_t expectedCount = 31;
+
+    shared_ptr<TokenizerConfig> config = make_shared<TokenizerConfig>();
+    config->compile(defaultParameters());
+    Tokenizer tokenizer;
+    tokenizer.config = config;
+    vector<string> tokens;
+    tokenizer.tokenize(sentence.data(), sentence.size(), [&](const char *data, size_t length) {
+        tokens.push_back(string(data, length));
+    });
+
+    set<string> actual(tokens.begin(), tokens.end());
+    if (actual != expected || tokens.size() != expectedCount) {
+        fprintf(stderr, "FAIL golden output: %zu tokens, %zu distinct\n", tokens.size(), actual.size());
+        for (const string &token : tokens) {
+            fprintf(stderr, "  %s\n", token.c_str());
+        }
+        return false;
+    }
+    printf("golden output: OK (%zu tokens, %zu distinct)\n", tokens.size(), actual.size());
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (!checkGolden()) {
+        return 1;
+    }
+
+    string corpus;
+    if (argc > 1) {
+        if (!readFile(argv[1], corpus)) {
+            fprintf(stderr, "Cannot read %s\n", argv[1]);
+            return 1;
+        }
+    } else { // Repeat the example in README.md
+        const string line = "2014-05-10 00:00:05.700433 %ASA-6-302013: Built outbound TCP connection 9986454 for "
+                            "outside:101.123.123.111/443 (101.123.123.111/443)\n";
+        while (corpus.size() < 64 * 1024 * 1024) {
+            corpus += line;
+        }
+    }
+    int iterations = argc > 2 ? atoi(argv[2]) : 3;
+
+    // Configuration parameters can be overridden by name=value arguments
+    map<string, string> parameters = defaultParameters();
+    for (int i = 3; i < argc; ++i) {
+        const char *eq = strchr(argv[i], '=');
+        if (eq == nullptr) {
+            fprintf(stderr, "Invalid parameter %s, expected name=value\n", argv[i]);
+            return 1;
+        }
+        parameters[string(argv[i], eq - argv[i])] = string(eq + 1);
+    }
+    shared_ptr<TokenizerConfig> config = make_shared<TokenizerConfig>();
+    try {
+        config->compile(parameters);
+    } catch (const exception &e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    Tokenizer tokenizer;
+    tokenizer.config = config;
+    BenchReader reader(corpus);
+    BenchWriter writer(config->maxLength == SIZE_MAX ? corpus.size() : config->maxLength);
+
+    // Same loop as processPartition
+    auto emit = [&](const char *data, size_t length) {
+        writer.setToken(data, length);
+        writer.setId(reader.getId());
+        writer.next();
+    };
+
+    size_t inputRows = 0;
+    size_t allocationsBefore = allocations;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        reader.rewind();
+        do {
+            tokenizer.tokenize(reader.data(), reader.length(), emit);
+            ++inputRows;
+        } while (reader.next());
+    }
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    size_t rowAllocations = allocations - allocationsBefore;
+
+    printf("kernel:        %s\n", SeparatorScanner::kernelName(config->scanner.getKernel()));
+    printf("input:         %zu bytes, %zu rows x %d iterations\n", corpus.size(), inputRows / iterations, iterations);
+    printf("output:        %zu tokens, %zu filtered\n", writer.rows, tokenizer.takeFilteredTokens());
+    printf("throughput:    %.1f MB/s, %.0f tokens/s\n", static_cast<double>(corpus.size()) * iterations / sec / 1e6, writer.rows / sec);
+    printf("allocations:   %zu (%.3f per input row)\n", rowAllocations, static_cast<double>(rowAllocations) / inputRows);
+    return 0;
+}
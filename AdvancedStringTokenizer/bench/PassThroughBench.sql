@@ -0,0 +1,30 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: SQL script to measure AdvancedStringTokenizer with 0, 1 and 5 pass-through columns
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+-- Create Benchmark table
+CREATE TABLE public.ast_passthrough_bench (id INT, text VARCHAR(1000), host VARCHAR(64) DEFAULT 'host' || (id % 100)::VARCHAR, severity INT DEFAULT id % 8, score FLOAT DEFAULT id / 7, acked BOOLEAN DEFAULT id % 2 = 0, logged_at TIMESTAMP DEFAULT '2024-09-24 00:00:00'::TIMESTAMP + (id || ' seconds')::INTERVAL);
+
+-- Load Benchmark data (about 60 tokens per row)
+\! for i in {1..200000}; do echo "${i}|2014-05-10 00:00:05.700433 %ASA-6-302013: Built outbound TCP connection ${i} for outside:101.123.123.111/443 (101.123.123.111/443) to inside:10.0.0.$((${i} % 250))/51234 (10.0.0.$((${i} % 250))/51234) duration 0:00:${i} bytes ${i} TCP FINs user=admin@example.com"; done | vsql -c 'COPY public.ast_passthrough_bench (id, text) FROM LOCAL STDIN;'
+
+\timing on
+
+-- Benchmark 1: No pass-through column
+SELECT COUNT(*) FROM (SELECT AdvancedStringTokenizer(id, text) OVER (PARTITION BEST) FROM public.ast_passthrough_bench) s;
+
+-- Benchmark 2: 1 pass-through column
+SELECT COUNT(*) FROM (SELECT AdvancedStringTokenizer(id, text, id) OVER (PARTITION BEST) FROM public.ast_passthrough_bench) s;
+
+-- Benchmark 3: 5 pass-through columns
+SELECT COUNT(*) FROM (SELECT AdvancedStringTokenizer(id, text, host, severity, score, acked, logged_at) OVER (PARTITION BEST) FROM public.ast_passthrough_bench) s;
+
+\timing off
+
+-- Drop Benchmark table
+DROP TABLE public.ast_passthrough_bench CASCADE;
@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Benchmark of SeparatorScanner kernels over a log corpus
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../SeparatorScanner.hpp"
+
+using namespace std;
+
+static const string DEFAULT_MINOR = "/:=@.-$#%\\_";
+static const string DEFAULT_MAJOR = " []<>(){}|!;,'\"*&?+\r\n\t";
+
+/**
+ * Generate a corpus that resembles firewall, web access and application logs.
+ */
+static string generateCorpus(size_t targetSize)
+{
+    mt19937 rng(1);
+    stringstream ss;
+    const char *methods[] = {"GET", "POST", "PUT"};
+    while (static_cast<size_t>(ss.tellp()) < targetSize) {
+        unsigned a = rng() % 256, b = rng() % 256, port = rng() % 65536;
+        switch (rng() % 4) {
+        case 0:
+            ss << "2014-05-10 00:00:05.700433 %ASA-6-302013: Built outbound TCP connection " << rng() % 10000000
+               << " for outside:101.123." << a << "." << b << "/" << port << " (101.123." << a << "." << b << "/" << port << ")\n";
+            break;
+        case 1:
+            ss << "10.0." << a << "." << b << " - - [10/May/2014:00:00:05 +0900] \"" << methods[rng() % 3]
+               << " /api/v1/items/" << rng() << "?sort=desc&page=" << rng() % 100 << " HTTP/1.1\" 200 " << rng() % 100000 << "\n";
+            break;
+        case 2:
+            ss << "java.lang.IllegalStateException: Unexpected state\n"
+               << "\tat com.example.service.OrderService.process(OrderService.java:" << rng() % 1000 << ")\n"
+               << "\tat com.example.service.OrderController.handle(OrderController.java:" << rng() % 1000 << ")\n";
+            break;
+        default: // Long payload with few separators
+            ss << "payload ";
+            for (int i = 0; i < 16; ++i) {
+                ss << hex << rng() << rng() << dec;
+            }
+            ss << "\n";
+            break;
+        }
+    }
+    return ss.str();
+}
+
+/**
+ * Walk through all separators in the corpus like the tokenizer does, and return the number of hits.
+ */
+static size_t walk(const SeparatorScanner &scanner, const string &corpus)
+{
+    size_t hits = 0, pos = 0;
+    const size_t len = corpus.size();
+    while ((pos = scanner.findNext(corpus.data(), pos, len)) < len) {
+        ++hits;
+        ++pos;
+    }
+    return hits;
+}
+
+static void run(const char *label, const string &major, const string &minor, const string &corpus, int iterations)
+{
+    for (SeparatorScanner::Kernel k : {SeparatorScanner::KERNEL_SCALAR, SeparatorScanner::KERNEL_SSE42, SeparatorScanner::KERNEL_AVX2}) {
+        SeparatorScanner scanner;
+        scanner.compile(major, minor);
+        if (!scanner.setKernel(k)) {
+            printf("%-24s %-8s not supported\n", label, SeparatorScanner::kernelName(k));
+            continue;
+        }
+
+        size_t hits = walk(scanner, corpus); // warm up
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            hits = walk(scanner, corpus);
+        }
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        printf("%-24s %-8s %10.1f MB/s  separators: %zu\n", label, SeparatorScanner::kernelName(k),
+               static_cast<double>(corpus.size()) * iterations / sec / 1e6, hits);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    string corpus;
+    if (argc > 1) {
+        ifstream ifs(argv[1], ios::binary);
+        if (!ifs) {
+            fprintf(stderr, "Could not open corpus file [%s]\n", argv[1]);
+            return 1;
+        }
+        corpus.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+    } else {
+        corpus = generateCorpus(64 * 1024 * 1024);
+    }
+    int iterations = argc > 2 ? atoi(argv[2]) : 5;
+    printf("corpus: %zu bytes, iterations: %d\n", corpus.size(), iterations);
+
+    run("default separators", DEFAULT_MAJOR, DEFAULT_MINOR, corpus, iterations);
+    run("whitespace separators", " \t\r\n", "", corpus, iterations);
+    return 0;
+}
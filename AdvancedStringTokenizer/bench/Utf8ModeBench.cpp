@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Benchmark of Tokenizer in byte mode and UTF-8 mode over ASCII, German, Japanese and mixed corpora
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "../Tokenizer.hpp"
+
+using namespace std;
+
+static const char *ASCII_WORDS[] = {"connection", "outside:101.123.123.111/443", "%ASA-6-302013:", "Built", "TCP", "for", "2014-05-10"};
+static const char *GERMAN_WORDS[] = {"Verbindung", "hergestellt", "f\xc3\xbcr", "Stra\xc3\x9f" "e", "\xc3\x9c" "berpr\xc3\xbc" "fung", "Gr\xc3\xb6\xc3\x9f" "e"};
+static const char *JAPANESE_WORDS[] = {"\xe6\x8e\xa5\xe7\xb6\x9a", "\xe3\x82\x92", "\xe7\xa2\xba\xe7\xab\x8b", "\xe3\x81\x97\xe3\x81\xbe\xe3\x81\x97\xe3\x81\x9f",
+                                       "\xe3\x80\x81", "\xe3\x80\x82", "\xe3\x82\xb5\xe3\x83\xbc\xe3\x83\x90", "\xe3\x80\x80"};
+
+template <size_t N>
+static string generate(const char *(&words)[N], size_t targetSize, mt19937 &rng, bool spaces)
+{
+    string corpus;
+    while (corpus.size() < targetSize) {
+        corpus += words[rng() % N];
+        corpus += (rng() % 16 == 0) ? "\n" : (spaces ? " " : "");
+    }
+    return corpus;
+}
+
+static void run(const char *label, const string &corpus, const map<string, string> &parameters, int iterations)
+{
+    shared_ptr<TokenizerConfig> config = make_shared<TokenizerConfig>();
+    config->compile(parameters);
+    Tokenizer tokenizer;
+    tokenizer.config = config;
+
+    size_t tokens = 0, bytes = 0;
+    auto count = [&](const char *, size_t n) { ++tokens; bytes += n; };
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        size_t lineStart = 0;
+        while (lineStart < corpus.size()) { // One row per line
+            size_t lineEnd = corpus.find('\n', lineStart);
+            if (lineEnd == string::npos) {
+                lineEnd = corpus.size();
+            }
+            tokenizer.tokenize(corpus.data() + lineStart, lineEnd - lineStart, count);
+            lineStart = lineEnd + 1;
+        }
+    }
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("%-34s %9.1f MB/s %12.0f tokens/s\n", label, static_cast<double>(corpus.size()) * iterations / sec / 1e6, tokens / sec);
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 3;
+    const size_t size = 16 * 1024 * 1024;
+    mt19937 rng(1);
+    map<string, string> corpora = {
+        {"ascii", generate(ASCII_WORDS, size, rng, true)},
+        {"german", generate(GERMAN_WORDS, size, rng, true)},
+        {"japanese", generate(JAPANESE_WORDS, size, rng, false)}
+    };
+    string mixed;
+    while (mixed.size() < size) {
+        mixed += corpora["ascii"].substr(rng() % (size / 2), 256) + corpora["japanese"].substr(rng() % (size / 2), 255) + "\n";
+    }
+    corpora["mixed"] = mixed;
+
+    map<string, string> byteMode = defaultParameters();
+    map<string, string> utf8Mode = byteMode;
+    utf8Mode[PARAM_UTF8MODE] = "true";
+    map<string, string> utf8Classes = utf8Mode;
+    utf8Classes[PARAM_UNICODESEPARATORS] = "whitespace,punctuation";
+
+    for (const auto &corpus : corpora) {
+        run((corpus.first + " byte mode").c_str(), corpus.second, byteMode, iterations);
+        run((corpus.first + " utf8 mode").c_str(), corpus.second, utf8Mode, iterations);
+        run((corpus.first + " utf8 mode with unicode classes").c_str(), corpus.second, utf8Classes, iterations);
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Differential test of SeparatorScanner SIMD kernels against the scalar kernel
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../SeparatorScanner.hpp"
+
+using namespace std;
+
+static const string DEFAULT_MINOR = "/:=@.-$#%\\_";
+static const string DEFAULT_MAJOR = " []<>(){}|!;,'\"*&?+\r\n\t";
+
+/**
+ * Compare every position returned by the kernel with the scalar kernel while walking through the data.
+ */
+static bool compareKernel(SeparatorScanner &scanner, SeparatorScanner::Kernel kernel, const string &data, size_t start)
+{
+    SeparatorScanner reference = scanner;
+    reference.setKernel(SeparatorScanner::KERNEL_SCALAR);
+    scanner.setKernel(kernel);
+
+    for (size_t len = start; len <= data.size(); len += (len < start + 80 ? 1 : 37)) {
+        size_t pos = start;
+        while (pos <= len) {
+            size_t expected = reference.findNext(data.data(), pos, len);
+            size_t actual = scanner.findNext(data.data(), pos, len);
+            if (expected != actual) {
+                fprintf(stderr, "FAIL kernel=%s start=%zu len=%zu pos=%zu expected=%zu actual=%zu\n",
+                        SeparatorScanner::kernelName(kernel), start, len, pos, expected, actual);
+                return false;
+            }
+            pos = expected + 1;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    vector<SeparatorScanner::Kernel> kernels;
+    for (SeparatorScanner::Kernel k : {SeparatorScanner::KERNEL_SSE42, SeparatorScanner::KERNEL_AVX2}) {
+        if (SeparatorScanner::isSupported(k)) {
+            kernels.push_back(k);
+        } else {
+            printf("SKIP kernel %s is not supported on this CPU\n", SeparatorScanner::kernelName(k));
+        }
+    }
+
+    mt19937 rng(20240924);
+    size_t failures = 0, cases = 0;
+
+    // Random separator sets over the whole byte range, including bytes with the top bit set
+    for (int round = 0; round < 200; ++round) {
+        string major, minor;
+        size_t numSeps = rng() % 24;
+        for (size_t i = 0; i < numSeps; ++i) {
+            char c = static_cast<char>(rng() % 256);
+            (rng() % 2 ? major : minor) += c;
+        }
+        if (round % 10 == 0) {
+            major = DEFAULT_MAJOR;
+            minor = DEFAULT_MINOR;
+        }
+
+        // Sparse separators exercise long runs inside vectors, dense ones exercise the first-hit mask
+        string data(300 + rng() % 200, 'x');
+        size_t density = 1 + rng() % 64;
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<char>(rng() % density == 0 && numSeps > 0
+                                        ? (major + minor)[rng() % (major.size() + minor.size())]
+                                        : rng() % 256);
+        }
+
+        SeparatorScanner scanner;
+        scanner.compile(major, minor);
+        for (SeparatorScanner::Kernel k : kernels) {
+            for (size_t start = 0; start < 33; ++start) {
+                ++cases;
+                if (!compareKernel(scanner, k, data, start)) {
+                    ++failures;
+                }
+            }
+        }
+    }
+
+    // Class table must agree with the original linear lookup with major taking precedence
+    SeparatorScanner scanner;
+    scanner.compile(DEFAULT_MAJOR, DEFAULT_MINOR + " ");
+    for (int c = 0; c < 256; ++c) {
+        uint8_t expected = DEFAULT_MAJOR.find(static_cast<char>(c)) != string::npos ? SeparatorScanner::CLASS_MAJOR
+                         : DEFAULT_MINOR.find(static_cast<char>(c)) != string::npos ? SeparatorScanner::CLASS_MINOR
+                         : SeparatorScanner::CLASS_NONE;
+        ++cases;
+        if (scanner.classOf(static_cast<char>(c)) != expected) {
+            fprintf(stderr, "FAIL classOf(0x%02x)\n", c);
+            ++failures;
+        }
+    }
+
+    printf("%s: %zu cases, %zu failures\n", failures == 0 ? "PASS" : "FAIL", cases, failures);
+    return failures == 0 ? 0 : 1;
+}
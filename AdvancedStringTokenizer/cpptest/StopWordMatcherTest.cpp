@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Test of StopWordMatcher against a set of lowercased strings
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_set>
+
+#include "../StopWordMatcher.hpp"
+
+using namespace std;
+
+static string lower(string str)
+{
+    transform(str.begin(), str.end(), str.begin(), [](char c) { return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c; });
+    return str;
+}
+
+int main()
+{
+    size_t failures = 0, cases = 0;
+    mt19937 rng(20240924);
+    const string alphabet = "aAbBtThHeE.-\xc3\xa9";
+
+    for (int round = 0; round < 100; ++round) {
+        // Build a list of stop words with empty entries and duplicates in different cases
+        string list;
+        unordered_set<string> reference;
+        size_t numWords = round == 0 ? 0 : rng() % 50;
+        for (size_t i = 0; i < numWords; ++i) {
+            string word;
+            size_t len = rng() % 6;
+            for (size_t j = 0; j < len; ++j) {
+                word += alphabet[rng() % alphabet.size()];
+            }
+            list += word + ",";
+            if (!word.empty()) {
+                reference.insert(lower(word));
+            }
+        }
+
+        StopWordMatcher matcher;
+        matcher.compile(list);
+        if (matcher.empty() != reference.empty()) {
+            fprintf(stderr, "FAIL empty() list=[%s]\n", list.c_str());
+            ++failures;
+        }
+
+        for (int i = 0; i < 2000; ++i) {
+            string word;
+            size_t len = rng() % 8;
+            for (size_t j = 0; j < len; ++j) {
+                word += alphabet[rng() % alphabet.size()];
+            }
+            bool expected = !word.empty() && reference.count(lower(word)) > 0;
+            ++cases;
+            if (matcher.isStopWord(word.data(), word.size()) != expected) {
+                fprintf(stderr, "FAIL word=[%s] list=[%s] expected=%d\n", word.c_str(), list.c_str(), expected);
+                ++failures;
+            }
+        }
+    }
+
+    printf("%s: %zu cases, %zu failures\n", failures == 0 ? "PASS" : "FAIL", cases, failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,341 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Differential test of Tokenizer against the original character-by-character tokenizer
+ *
+ * Create Date: September 24, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "../Tokenizer.hpp"
+
+using namespace std;
+
+static const string DEFAULT_MINOR = "/:=@.-$#%\\_";
+static const string DEFAULT_MAJOR = " []<>(){}|!;,'\"*&?+\r\n\t";
+
+/**
+ * Reference : The tokenizer loop as it was written before the scanner and the filters were introduced
+ */
+struct Reference
+{
+    string minorSeparators, majorSeparators;
+    unordered_set<string> stopWords;
+    size_t minLength = 0, maxLength = 65000;
+    bool prevCharMinorSep = false, prevCharMajorSep = false;
+
+    bool isSeparator(char data, const string &separators)
+    {
+        return separators.find(data) != string::npos;
+    }
+
+    bool isMajorSeparator(char data)
+    {
+        bool flag = isSeparator(data, majorSeparators);
+        if (!flag) {
+            prevCharMajorSep = false;
+        }
+        return flag;
+    }
+
+    bool isMinorSeparator(char data)
+    {
+        bool flag = isSeparator(data, minorSeparators);
+        if (!flag) {
+            prevCharMinorSep = false;
+        }
+        return flag;
+    }
+
+    void add(vector<string> &out, const char *p, size_t n)
+    {
+        string str(p, n), folded = str;
+        transform(folded.begin(), folded.end(), folded.begin(), [](char c) { return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c; });
+        if (folded.empty() || stopWords.find(folded) == stopWords.end()) {
+            out.push_back(str);
+        }
+    }
+
+    void tokenize(const string &sentence, vector<string> &out)
+    {
+        size_t wordStart = 0, wordEnd = 0, wordMinorStart = 0;
+        bool majorFlag = false, minorFlag = false;
+        const char *sentenceData = sentence.data();
+        size_t sentenseLength = sentence.size();
+
+        while (wordEnd < sentenseLength) {
+            while (wordEnd < sentenseLength) {
+                if (isMajorSeparator(sentenceData[wordEnd])) {
+                    majorFlag = true;
+                    break;
+                } else if (isMinorSeparator(sentenceData[wordEnd])) {
+                    minorFlag = true;
+                    break;
+                }
+                ++wordEnd;
+            }
+            if (minorFlag || wordStart != wordMinorStart) {
+                if (!prevCharMajorSep && !prevCharMinorSep && minLength <= wordEnd - wordMinorStart) {
+                    add(out, &sentenceData[wordMinorStart], min(maxLength, wordEnd - wordMinorStart));
+                }
+                wordMinorStart = wordEnd + 1;
+                prevCharMinorSep = true;
+                minorFlag = false;
+            }
+            if (majorFlag || sentenseLength == wordEnd || sentenseLength == wordMinorStart) {
+                if (!majorFlag && sentenseLength == wordMinorStart) {
+                    ++wordEnd;
+                }
+                if (!prevCharMajorSep && minLength <= wordEnd - wordStart) {
+                    add(out, &sentenceData[wordStart], min(maxLength, wordEnd - wordStart));
+                }
+                wordStart = wordEnd + 1;
+                wordMinorStart = wordStart;
+                prevCharMajorSep = true;
+                majorFlag = false;
+            }
+            ++wordEnd;
+        }
+    }
+};
+
+static Tokenizer makeTokenizer(const map<string, string> &parameters)
+{
+    shared_ptr<TokenizerConfig> config = make_shared<TokenizerConfig>();
+    config->compile(parameters);
+    Tokenizer tokenizer;
+    tokenizer.config = config;
+    return tokenizer;
+}
+
+static vector<string> tokenize(Tokenizer &tokenizer, const string &sentence)
+{
+    vector<string> tokens;
+    tokenizer.tokenize(sentence.data(), sentence.size(), [&](const char *p, size_t n) { tokens.push_back(string(p, n)); });
+    return tokens;
+}
+
+int main()
+{
+    size_t failures = 0, cases = 0;
+    mt19937 rng(20240924);
+    const string alphabet = "abcTHE01 .:/-[]()\t\xe3\x81\x82";
+    const char *stopWordLists[] = {"", "the,a", "THE,ab,,c0"};
+
+    for (int round = 0; round < 300; ++round) {
+        Reference reference;
+        Tokenizer tokenizer;
+
+        reference.majorSeparators = DEFAULT_MAJOR;
+        reference.minorSeparators = DEFAULT_MINOR;
+        reference.minLength = rng() % 4;
+        reference.maxLength = 1 + rng() % 10;
+        string stopWords = stopWordLists[round % 3];
+        for (size_t start = 0, end; start <= stopWords.size(); start = end + 1) {
+            end = min(stopWords.find(',', start), stopWords.size());
+            string word = stopWords.substr(start, end - start);
+            transform(word.begin(), word.end(), word.begin(), [](char c) { return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c; });
+            if (!word.empty()) {
+                reference.stopWords.insert(word);
+            }
+        }
+
+        map<string, string> parameters = {
+            {PARAM_MAJORSEPARATORS, DEFAULT_MAJOR},
+            {PARAM_MINORSEPARATORS, DEFAULT_MINOR},
+            {PARAM_STOPWORDSCASEINSENSITIVE, stopWords},
+            {PARAM_MINLENGTH, to_string(reference.minLength)},
+            {PARAM_MAXLENGTH, to_string(reference.maxLength)}
+        };
+        tokenizer = makeTokenizer(parameters);
+
+        // Several rows per round, since the previous separator flags are carried over rows
+        for (int row = 0; row < 20; ++row) {
+            string sentence;
+            size_t len = rng() % 80;
+            for (size_t i = 0; i < len; ++i) {
+                sentence += alphabet[rng() % alphabet.size()];
+            }
+
+            vector<string> expected, actual = tokenize(tokenizer, sentence);
+            reference.tokenize(sentence, expected);
+
+            ++cases;
+            if (expected != actual) {
+                fprintf(stderr, "FAIL sentence=[%s] minlength=%zu maxlength=%zu expected=%zu tokens actual=%zu tokens\n",
+                        sentence.c_str(), reference.minLength, reference.maxLength, expected.size(), actual.size());
+                ++failures;
+            }
+        }
+    }
+
+    // UTF-8 mode without multi-byte separators must tokenize like the byte mode as long as no token is truncated
+    for (int round = 0; round < 100; ++round) {
+        Reference reference;
+        reference.majorSeparators = DEFAULT_MAJOR;
+        reference.minorSeparators = DEFAULT_MINOR;
+        reference.minLength = rng() % 4;
+
+        map<string, string> parameters = defaultParameters();
+        parameters[PARAM_MINLENGTH] = to_string(reference.minLength);
+        parameters[PARAM_MAXLENGTH] = to_string(reference.maxLength);
+        parameters[PARAM_UTF8MODE] = "true";
+        Tokenizer tokenizer = makeTokenizer(parameters);
+
+        for (int row = 0; row < 20; ++row) {
+            string sentence;
+            size_t len = rng() % 80;
+            for (size_t i = 0; i < len; ++i) {
+                sentence += alphabet[rng() % alphabet.size()];
+            }
+            vector<string> expected;
+            reference.tokenize(sentence, expected);
+            ++cases;
+            if (expected != tokenize(tokenizer, sentence)) {
+                fprintf(stderr, "FAIL utf8mode sentence=[%s]\n", sentence.c_str());
+                ++failures;
+            }
+        }
+    }
+
+    // Multi-byte separators, Unicode separator classes and truncation on character boundaries
+    {
+        map<string, string> parameters = defaultParameters();
+        parameters[PARAM_UTF8MODE] = "true";
+        parameters[PARAM_MINLENGTH] = "1";
+        parameters[PARAM_MINORSEPARATORS] += "\xe2\x86\x92"; // RIGHTWARDS ARROW
+        parameters[PARAM_UNICODESEPARATORS] = "whitespace,punctuation";
+        Tokenizer tokenizer = makeTokenizer(parameters);
+
+        struct {
+            const char *sentence;
+            vector<string> tokens;
+        } expected[] = {
+            {"\xe6\x9d\xb1\xe4\xba\xac\xe3\x80\x81\xe5\xa4\xa7\xe9\x98\xaa\xe3\x80\x80Stra\xc3\x9f" "e",
+             {"\xe6\x9d\xb1\xe4\xba\xac", "\xe5\xa4\xa7\xe9\x98\xaa", "Stra\xc3\x9f" "e"}},
+            {"a\xe2\x86\x92" "b c", {"a", "b", "a\xe2\x86\x92" "b", "c"}},
+            {"x\xe2\x86\x92", {"x", "x\xe2\x86\x92"}},
+            {"\xc2\xbfqu\xc3\xa9?", {"qu\xc3\xa9"}}
+        };
+        for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); ++i) {
+            ++cases;
+            if (tokenize(tokenizer, expected[i].sentence) != expected[i].tokens) {
+                fprintf(stderr, "FAIL unicode separators sentence=[%s]\n", expected[i].sentence);
+                ++failures;
+            }
+        }
+
+        parameters[PARAM_MAXLENGTH] = "4";
+        tokenizer = makeTokenizer(parameters);
+        vector<string> truncated = tokenize(tokenizer, "\xe6\x9d\xb1\xe4\xba\xac ab\xc3\xa9\xc3\xa9");
+        ++cases;
+        if (truncated != vector<string>({"\xe6\x9d\xb1", "ab\xc3\xa9"})) {
+            fprintf(stderr, "FAIL truncation on character boundaries\n");
+            ++failures;
+        }
+    }
+
+    // Character n-grams of major tokens in byte mode and UTF-8 mode, and the token hash
+    {
+        map<string, string> parameters = defaultParameters();
+        parameters[PARAM_NGRAMLENGTH] = "3";
+        Tokenizer tokenizer = makeTokenizer(parameters);
+        ++cases;
+        if (tokenize(tokenizer, "abcd.ef xyz") != vector<string>({"abcd", "ef", "abcd.ef", "abc", "bcd", "cd.", "d.e", ".ef", "xyz"})) {
+            fprintf(stderr, "FAIL n-grams in byte mode\n");
+            ++failures;
+        }
+
+        // The n-grams are taken from the token truncated to maxlength
+        parameters[PARAM_MAXLENGTH] = "5";
+        tokenizer = makeTokenizer(parameters);
+        ++cases;
+        if (tokenize(tokenizer, "abcdefgh") != vector<string>({"abcde", "abc", "bcd", "cde"})) {
+            fprintf(stderr, "FAIL n-grams of truncated token\n");
+            ++failures;
+        }
+        parameters[PARAM_MAXLENGTH] = "128";
+
+        parameters[PARAM_UTF8MODE] = "true";
+        parameters[PARAM_MINLENGTH] = "1";
+        tokenizer = makeTokenizer(parameters);
+        ++cases;
+        if (tokenize(tokenizer, "\xe6\x9d\xb1\xe4\xba\xac\xe9\x83\xbd\xe5\xba\x81") !=
+            vector<string>({"\xe6\x9d\xb1\xe4\xba\xac\xe9\x83\xbd\xe5\xba\x81", "\xe6\x9d\xb1\xe4\xba\xac\xe9\x83\xbd", "\xe4\xba\xac\xe9\x83\xbd\xe5\xba\x81"})) {
+            fprintf(stderr, "FAIL n-grams in UTF-8 mode\n");
+            ++failures;
+        }
+
+        ++cases;
+        if (Tokenizer::hashToken("a", 1) != 0xaf63dc4c8601ec8cULL || Tokenizer::hashToken("", 0) != 0xcbf29ce484222325ULL) {
+            fprintf(stderr, "FAIL token hash\n");
+            ++failures;
+        }
+    }
+
+    // Each distinct token is emitted once per row, and the set is cleared between rows
+    {
+        map<string, string> parameters = defaultParameters();
+        parameters[PARAM_UNIQUETOKENS] = "true";
+        Tokenizer tokenizer = makeTokenizer(parameters);
+        for (int row = 0; row < 2; ++row) {
+            ++cases;
+            if (tokenize(tokenizer, "10.0.0.1 GET 10.0.0.1 GET /10/0") != vector<string>({"10", "10.0.0.1", "GET", "/10/0"})) {
+                fprintf(stderr, "FAIL unique tokens row %d\n", row);
+                ++failures;
+            }
+        }
+
+        // Many distinct tokens in one row make the set grow
+        string sentence;
+        for (int i = 0; i < 1000; ++i) {
+            sentence += "w" + to_string(i % 700) + " ";
+        }
+        ++cases;
+        if (tokenize(tokenizer, sentence).size() != 700) {
+            fprintf(stderr, "FAIL unique tokens with growth\n");
+            ++failures;
+        }
+    }
+
+    // Parallel tokenization of large texts must emit the same tokens in the same order as the serial one
+    for (int round = 0; round < 60; ++round) {
+        map<string, string> parameters = defaultParameters();
+        parameters[PARAM_MINLENGTH] = to_string(rng() % 3);
+        parameters[PARAM_NGRAMLENGTH] = to_string(rng() % 2 * 3);
+        parameters[PARAM_UNIQUETOKENS] = (round % 2 == 0) ? "true" : "false";
+        parameters[PARAM_UTF8MODE] = (round % 3 == 0) ? "true" : "false";
+        parameters[PARAM_UNICODESEPARATORS] = (round % 3 == 0) ? "whitespace,punctuation" : "";
+        parameters[PARAM_PARALLELTHRESHOLD] = "0";
+        Tokenizer serial = makeTokenizer(parameters);
+        parameters[PARAM_PARALLELTHRESHOLD] = to_string(1 + rng() % 200);
+        parameters[PARAM_PARALLELTHREADS] = to_string(2 + rng() % 7);
+        Tokenizer parallel = makeTokenizer(parameters);
+
+        for (int row = 0; row < 10; ++row) {
+            string sentence;
+            size_t len = rng() % 2000;
+            for (size_t i = 0; i < len; ++i) {
+                sentence += alphabet[rng() % alphabet.size()];
+            }
+            ++cases;
+            if (tokenize(serial, sentence) != tokenize(parallel, sentence)
+                || serial.takeFilteredTokens() != parallel.takeFilteredTokens()) {
+                fprintf(stderr, "FAIL parallel round=%d row=%d sentence=[%s]\n", round, row, sentence.c_str());
+                ++failures;
+            }
+        }
+    }
+
+    printf("%s: %zu cases, %zu failures\n", failures == 0 ? "PASS" : "FAIL", cases, failures);
+    return failures == 0 ? 0 : 1;
+}
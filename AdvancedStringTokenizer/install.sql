@@ -19,3 +19,9 @@ SELECT SetAdvancedStringTokenizerParameter('minorseparators', E'/:=@.-$#%\\_');
 SELECT SetAdvancedStringTokenizerParameter('majorseparators', E' []<>(){}|!;,''"*&?+\r\n\t');
 SELECT SetAdvancedStringTokenizerParameter('minlength', '2');
 SELECT SetAdvancedStringTokenizerParameter('maxlength', '128');
+SELECT SetAdvancedStringTokenizerParameter('utf8mode', 'false');
+SELECT SetAdvancedStringTokenizerParameter('unicodeseparators', '');
+SELECT SetAdvancedStringTokenizerParameter('ngramlength', '0');
+SELECT SetAdvancedStringTokenizerParameter('uniquetokens', 'false');
+SELECT SetAdvancedStringTokenizerParameter('parallelthreshold', '1048576');
+SELECT SetAdvancedStringTokenizerParameter('parallelthreads', '1');
@@ -0,0 +1,279 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: AvroDecoder : Decode Avro binary data into JSON text with a compiled schema
+ *
+ * Create Date: March 15, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef AVRO_DECODER_HPP
+#define AVRO_DECODER_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "AvroSchema.hpp"
+
+/**
+ * AvroDecoder : Decode a datum of the schema into JSON
+ *
+ * A union is written as the value of the selected branch without the type name, so that a JSON parser
+ * loads it like the other values. Bytes and fixed are written as strings whose characters are the byte
+ * values, as in the JSON encoding of Avro. NaN and infinities are written as null.
+ *
+ * The count of an array or map block is taken from the data, so it must fit in the rest of the data unless
+ * the items can be encoded in zero bytes, and the zero-byte items are limited to MAX_EMPTY_ITEMS per datum.
+ */
+class AvroDecoder
+{
+
+public:
+    explicit AvroDecoder(const AvroSchema &schema_) : schema(schema_) {}
+
+    /**
+     * Append the JSON of the datum to json, and return false if the data is malformed or has extra bytes.
+     */
+    bool decode(const char *data, size_t length, std::string &json)
+    {
+        emptyItems = 0;
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(data);
+        const uint8_t *end = p + length;
+        return decodeNode(schema.root(), p, end, json, 0) && p == end;
+    }
+
+private:
+    enum { MAX_DEPTH = 256 };
+
+    // Maximum number of the items encoded in zero bytes, such as null, in a datum
+    enum { MAX_EMPTY_ITEMS = 1 << 20 };
+
+    const AvroSchema &schema; // Compiled schema
+    size_t emptyItems = 0;    // Items encoded in zero bytes in the current datum
+
+    /**
+     * Read a zigzag-encoded variable-length long.
+     */
+    static bool readLong(const uint8_t *&p, const uint8_t *end, int64_t &value)
+    {
+        uint64_t n = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p == end) {
+                return false;
+            }
+            uint8_t b = *p++;
+            n |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) {
+                value = static_cast<int64_t>(n >> 1) ^ -static_cast<int64_t>(n & 1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Read a length which must fit in the rest of the data.
+     */
+    static bool readLength(const uint8_t *&p, const uint8_t *end, size_t &length)
+    {
+        int64_t value;
+        if (!readLong(p, end, value) || value < 0 || static_cast<uint64_t>(value) > static_cast<uint64_t>(end - p)) {
+            return false;
+        }
+        length = static_cast<size_t>(value);
+        return true;
+    }
+
+    static void appendNumber(std::string &out, const char *format, double value)
+    {
+        if (std::isnan(value) || std::isinf(value)) {
+            out += "null";
+            return;
+        }
+        char buf[32];
+        out.append(buf, snprintf(buf, sizeof(buf), format, value));
+    }
+
+    /**
+     * Write the bytes as a string of code points U+0000 to U+00FF.
+     */
+    static void appendBytes(std::string &out, const uint8_t *data, size_t length)
+    {
+        static const char hex[] = "0123456789abcdef";
+        out += '"';
+        for (size_t i = 0; i < length; ++i) {
+            uint8_t c = data[i];
+            if (c >= 0x20 && c < 0x80 && c != '"' && c != '\\') {
+                out += static_cast<char>(c);
+            } else if (c == '"' || c == '\\') {
+                out += '\\';
+                out += static_cast<char>(c);
+            } else {
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xF];
+            }
+        }
+        out += '"';
+    }
+
+    /**
+     * Decode the blocks of array or map.
+     */
+    bool decodeBlocks(const AvroSchema::Node &node, const uint8_t *&p, const uint8_t *end, std::string &out, int depth)
+    {
+        bool isMap = node.type == AvroSchema::TYPE_MAP;
+        bool emptyItem = !isMap && schema.node(node.children[0]).canBeEmpty; // A key of map takes at least one byte
+        bool first = true;
+        out += isMap ? '{' : '[';
+        while (true) {
+            int64_t count;
+            if (!readLong(p, end, count)) {
+                return false;
+            }
+            if (count == 0) {
+                break;
+            } else if (count == INT64_MIN) {
+                return false;
+            } else if (count < 0) { // The block size follows a negative count
+                int64_t blockSize;
+                if (!readLong(p, end, blockSize)) {
+                    return false;
+                }
+                count = -count;
+            }
+            if (emptyItem) {
+                if (static_cast<uint64_t>(count) > MAX_EMPTY_ITEMS - emptyItems) {
+                    return false;
+                }
+                emptyItems += count;
+            } else if (static_cast<uint64_t>(count) > static_cast<uint64_t>(end - p)) { // Each item takes at least one byte
+                return false;
+            }
+            for (int64_t i = 0; i < count; ++i) {
+                if (!first) {
+                    out += ',';
+                }
+                first = false;
+                if (isMap) {
+                    size_t length;
+                    if (!readLength(p, end, length)) {
+                        return false;
+                    }
+                    AvroSchema::appendJsonString(out, reinterpret_cast<const char *>(p), length);
+                    out += ':';
+                    p += length;
+                }
+                if (!decodeNode(node.children[0], p, end, out, depth + 1)) {
+                    return false;
+                }
+            }
+        }
+        out += isMap ? '}' : ']';
+        return true;
+    }
+
+    bool decodeNode(size_t idx, const uint8_t *&p, const uint8_t *end, std::string &out, int depth)
+    {
+        if (depth > MAX_DEPTH) {
+            return false;
+        }
+        const AvroSchema::Node &node = schema.node(idx);
+        int64_t value;
+        size_t length;
+        switch (node.type) {
+        case AvroSchema::TYPE_NULL:
+            out += "null";
+            return true;
+        case AvroSchema::TYPE_BOOLEAN:
+            if (p == end || *p > 1) {
+                return false;
+            }
+            out += *p++ ? "true" : "false";
+            return true;
+        case AvroSchema::TYPE_INT:
+        case AvroSchema::TYPE_LONG: {
+            if (!readLong(p, end, value)) {
+                return false;
+            }
+            char buf[24];
+            out.append(buf, snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value)));
+            return true;
+        }
+        case AvroSchema::TYPE_FLOAT: {
+            if (end - p < 4) {
+                return false;
+            }
+            float f;
+            memcpy(&f, p, 4); // Little endian as the hosts of Vertica
+            p += 4;
+            appendNumber(out, "%.9g", f);
+            return true;
+        }
+        case AvroSchema::TYPE_DOUBLE: {
+            if (end - p < 8) {
+                return false;
+            }
+            double d;
+            memcpy(&d, p, 8);
+            p += 8;
+            appendNumber(out, "%.17g", d);
+            return true;
+        }
+        case AvroSchema::TYPE_BYTES:
+            if (!readLength(p, end, length)) {
+                return false;
+            }
+            appendBytes(out, p, length);
+            p += length;
+            return true;
+        case AvroSchema::TYPE_STRING:
+            if (!readLength(p, end, length)) {
+                return false;
+            }
+            AvroSchema::appendJsonString(out, reinterpret_cast<const char *>(p), length);
+            p += length;
+            return true;
+        case AvroSchema::TYPE_RECORD:
+            out += '{';
+            for (size_t i = 0; i < node.children.size(); ++i) {
+                if (i > 0) {
+                    out += ',';
+                }
+                out += node.labels[i];
+                if (!decodeNode(node.children[i], p, end, out, depth + 1)) {
+                    return false;
+                }
+            }
+            out += '}';
+            return true;
+        case AvroSchema::TYPE_ENUM:
+            if (!readLong(p, end, value) || value < 0 || static_cast<uint64_t>(value) >= node.labels.size()) {
+                return false;
+            }
+            out += node.labels[value];
+            return true;
+        case AvroSchema::TYPE_ARRAY:
+        case AvroSchema::TYPE_MAP:
+            return decodeBlocks(node, p, end, out, depth);
+        case AvroSchema::TYPE_UNION:
+            if (!readLong(p, end, value) || value < 0 || static_cast<uint64_t>(value) >= node.children.size()) {
+                return false;
+            }
+            return decodeNode(node.children[value], p, end, out, depth + 1);
+        case AvroSchema::TYPE_FIXED:
+            if (static_cast<size_t>(end - p) < node.size) {
+                return false;
+            }
+            appendBytes(out, p, node.size);
+            p += node.size;
+            return true;
+        }
+        return false;
+    }
+};
+
+#endif // AVRO_DECODER_HPP
@@ -0,0 +1,502 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: AvroSchema : Compile an Avro schema in JSON into the nodes used by AvroDecoder
+ *
+ * Create Date: March 15, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef AVRO_SCHEMA_HPP
+#define AVRO_SCHEMA_HPP
+
+#include <cctype>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * JsonValue : Value of the JSON document of a schema
+ */
+struct JsonValue
+{
+    enum Kind { KIND_NULL, KIND_BOOL, KIND_NUMBER, KIND_STRING, KIND_ARRAY, KIND_OBJECT };
+
+    Kind kind = KIND_NULL;                                  // Kind of the value
+    bool boolean = false;                                   // Value of true or false
+    std::string string;                                     // Value of a string, or the text of a number
+    std::vector<JsonValue> items;                           // Items of an array
+    std::vector<std::pair<std::string, JsonValue>> members; // Members of an object
+
+    /**
+     * Find the member of the object, or return nullptr.
+     */
+    const JsonValue *get(const std::string &name) const
+    {
+        for (const auto &member : members) {
+            if (member.first == name) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * JsonReader : Parser of the JSON document of a schema
+ */
+class JsonReader
+{
+
+public:
+    explicit JsonReader(const std::string &text_) : text(text_) {}
+
+    /**
+     * Parse the whole document, and throw invalid_argument if it is not valid JSON.
+     */
+    JsonValue parse()
+    {
+        JsonValue value = parseValue(0);
+        skipSpaces();
+        if (pos != text.size()) {
+            fail("unexpected data after the value");
+        }
+        return value;
+    }
+
+private:
+    enum { MAX_DEPTH = 256 };
+
+    const std::string &text; // Document
+    size_t pos = 0;          // Current position
+
+    void fail(const char *reason) const
+    {
+        throw std::invalid_argument(std::string("Invalid JSON at offset ") + std::to_string(pos) + ": " + reason);
+    }
+
+    void skipSpaces()
+    {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+            ++pos;
+        }
+    }
+
+    bool consume(const char *literal)
+    {
+        size_t len = std::char_traits<char>::length(literal);
+        if (text.compare(pos, len, literal) == 0) {
+            pos += len;
+            return true;
+        }
+        return false;
+    }
+
+    JsonValue parseValue(int depth)
+    {
+        if (depth > MAX_DEPTH) {
+            fail("too deeply nested");
+        }
+        skipSpaces();
+        JsonValue value;
+        if (pos >= text.size()) {
+            fail("unexpected end");
+        } else if (text[pos] == '{') {
+            value.kind = JsonValue::KIND_OBJECT;
+            ++pos;
+            skipSpaces();
+            if (pos < text.size() && text[pos] == '}') {
+                ++pos;
+                return value;
+            }
+            while (true) {
+                skipSpaces();
+                if (pos >= text.size() || text[pos] != '"') {
+                    fail("expected a member name");
+                }
+                std::string name = parseString();
+                skipSpaces();
+                if (!consume(":")) {
+                    fail("expected ':'");
+                }
+                value.members.emplace_back(std::move(name), parseValue(depth + 1));
+                skipSpaces();
+                if (consume("}")) {
+                    return value;
+                } else if (!consume(",")) {
+                    fail("expected ',' or '}'");
+                }
+            }
+        } else if (text[pos] == '[') {
+            value.kind = JsonValue::KIND_ARRAY;
+            ++pos;
+            skipSpaces();
+            if (pos < text.size() && text[pos] == ']') {
+                ++pos;
+                return value;
+            }
+            while (true) {
+                value.items.push_back(parseValue(depth + 1));
+                skipSpaces();
+                if (consume("]")) {
+                    return value;
+                } else if (!consume(",")) {
+                    fail("expected ',' or ']'");
+                }
+            }
+        } else if (text[pos] == '"') {
+            value.kind = JsonValue::KIND_STRING;
+            value.string = parseString();
+        } else if (consume("true")) {
+            value.kind = JsonValue::KIND_BOOL;
+            value.boolean = true;
+        } else if (consume("false")) {
+            value.kind = JsonValue::KIND_BOOL;
+        } else if (consume("null")) {
+            value.kind = JsonValue::KIND_NULL;
+        } else {
+            size_t start = pos;
+            while (pos < text.size() && (isdigit(static_cast<unsigned char>(text[pos])) || text[pos] == '-' || text[pos] == '+'
+                                         || text[pos] == '.' || text[pos] == 'e' || text[pos] == 'E')) {
+                ++pos;
+            }
+            if (start == pos) {
+                fail("unexpected character");
+            }
+            value.kind = JsonValue::KIND_NUMBER;
+            value.string = text.substr(start, pos - start);
+        }
+        return value;
+    }
+
+    std::string parseString()
+    {
+        std::string result;
+        ++pos; // Opening quote
+        while (pos < text.size() && text[pos] != '"') {
+            char c = text[pos++];
+            if (c != '\\') {
+                result += c;
+                continue;
+            }
+            if (pos >= text.size()) {
+                break;
+            }
+            c = text[pos++];
+            switch (c) {
+            case 'b': result += '\b'; break;
+            case 'f': result += '\f'; break;
+            case 'n': result += '\n'; break;
+            case 'r': result += '\r'; break;
+            case 't': result += '\t'; break;
+            case 'u': appendUtf8(result, parseCodePoint()); break;
+            default: result += c; break; // '"', '\\' and '/'
+            }
+        }
+        if (pos >= text.size()) {
+            fail("unterminated string");
+        }
+        ++pos; // Closing quote
+        return result;
+    }
+
+    unsigned long parseHex4()
+    {
+        if (pos + 4 > text.size()) {
+            fail("invalid \\u escape");
+        }
+        std::string hex = text.substr(pos, 4);
+        char *end;
+        unsigned long code = strtoul(hex.c_str(), &end, 16);
+        if (end != hex.c_str() + 4) {
+            fail("invalid \\u escape");
+        }
+        pos += 4;
+        return code;
+    }
+
+    unsigned long parseCodePoint()
+    {
+        unsigned long code = parseHex4();
+        if (code >= 0xD800 && code < 0xDC00 && consume("\\u")) { // Surrogate pair
+            unsigned long low = parseHex4();
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+        return code;
+    }
+
+    static void appendUtf8(std::string &out, unsigned long code)
+    {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+};
+
+/**
+ * AvroSchema : Avro schema compiled into a flat list of nodes
+ *
+ * Named types are compiled once and referred to by their index, so a recursive record refers to itself.
+ * The names of record fields and enum symbols are rendered in JSON when compiled, so that the decoder
+ * only appends them. Logical types are decoded as their underlying types.
+ */
+class AvroSchema
+{
+
+public:
+    enum Type {
+        TYPE_NULL, TYPE_BOOLEAN, TYPE_INT, TYPE_LONG, TYPE_FLOAT, TYPE_DOUBLE, TYPE_BYTES, TYPE_STRING,
+        TYPE_RECORD, TYPE_ENUM, TYPE_ARRAY, TYPE_MAP, TYPE_UNION, TYPE_FIXED
+    };
+
+    /**
+     * Node : Compiled type
+     */
+    struct Node {
+        Type type;                       // Type of the node
+        std::vector<size_t> children;    // Fields of record, item of array, value of map, or branches of union
+        std::vector<std::string> labels; // '"name":' of the fields of record, or '"symbol"' of enum
+        size_t size = 0;                 // Size of fixed
+        bool canBeEmpty = false;         // The datum can be encoded in zero bytes, such as null
+    };
+
+    /**
+     * Compile the schema, and throw invalid_argument if it is not a valid Avro schema.
+     */
+    explicit AvroSchema(const std::string &json)
+    {
+        JsonValue document = JsonReader(json).parse();
+        rootIdx = compile(document, "");
+        markEmptyNodes();
+    }
+
+    size_t root() const
+    {
+        return rootIdx;
+    }
+
+    const Node &node(size_t idx) const
+    {
+        return nodes[idx];
+    }
+
+    /**
+     * Append the string to the JSON text with quotes and escapes.
+     */
+    static void appendJsonString(std::string &out, const char *data, size_t length)
+    {
+        static const char hex[] = "0123456789abcdef";
+        out += '"';
+        size_t start = 0;
+        for (size_t i = 0; i < length; ++i) {
+            unsigned char c = static_cast<unsigned char>(data[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            out.append(data + start, i - start);
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += static_cast<char>(c);
+            } else {
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xF];
+            }
+            start = i + 1;
+        }
+        out.append(data + start, length - start);
+        out += '"';
+    }
+
+private:
+    std::vector<Node> nodes;             // Compiled types
+    std::map<std::string, size_t> names; // Index of named types by full name
+    size_t rootIdx = 0;                  // Index of the top-level type
+
+    [[noreturn]] static void fail(const std::string &reason)
+    {
+        throw std::invalid_argument("Invalid Avro schema: " + reason);
+    }
+
+    /**
+     * Mark the nodes which can be encoded in zero bytes: null, fixed of size 0, and record whose fields are all
+     * such nodes. A record can refer to itself by name, so the records are marked until nothing changes.
+     */
+    void markEmptyNodes()
+    {
+        for (Node &node : nodes) {
+            node.canBeEmpty = node.type == TYPE_NULL || (node.type == TYPE_FIXED && node.size == 0);
+        }
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (Node &node : nodes) {
+                if (node.type != TYPE_RECORD || node.canBeEmpty) {
+                    continue;
+                }
+                bool empty = true;
+                for (size_t child : node.children) {
+                    empty = empty && nodes[child].canBeEmpty;
+                }
+                if (empty) {
+                    node.canBeEmpty = true;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    size_t addNode(Type type)
+    {
+        nodes.push_back(Node());
+        nodes.back().type = type;
+        return nodes.size() - 1;
+    }
+
+    static bool primitiveType(const std::string &name, Type &type)
+    {
+        static const std::pair<const char *, Type> primitives[] = {
+            {"null", TYPE_NULL}, {"boolean", TYPE_BOOLEAN}, {"int", TYPE_INT}, {"long", TYPE_LONG},
+            {"float", TYPE_FLOAT}, {"double", TYPE_DOUBLE}, {"bytes", TYPE_BYTES}, {"string", TYPE_STRING}
+        };
+        for (const auto &primitive : primitives) {
+            if (name == primitive.first) {
+                type = primitive.second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static std::string fullName(const std::string &name, const std::string &space)
+    {
+        return (name.find('.') != std::string::npos || space.empty()) ? name : space + "." + name;
+    }
+
+    static const JsonValue &require(const JsonValue &value, const char *name, JsonValue::Kind kind)
+    {
+        const JsonValue *member = value.get(name);
+        if (member == nullptr || member->kind != kind) {
+            fail(std::string("'") + name + "' is missing or has a wrong type");
+        }
+        return *member;
+    }
+
+    /**
+     * Register the named type, and return the namespace of its members.
+     */
+    std::string defineName(const JsonValue &value, const std::string &space, size_t idx)
+    {
+        const std::string &name = require(value, "name", JsonValue::KIND_STRING).string;
+        const JsonValue *nameSpace = value.get("namespace");
+        std::string full = fullName(name, (nameSpace != nullptr && nameSpace->kind == JsonValue::KIND_STRING) ? nameSpace->string : space);
+        if (!names.insert(std::make_pair(full, idx)).second) {
+            fail("'" + full + "' is defined twice");
+        }
+        size_t dot = full.rfind('.');
+        return dot == std::string::npos ? "" : full.substr(0, dot);
+    }
+
+    size_t compile(const JsonValue &value, const std::string &space)
+    {
+        Type type;
+        if (value.kind == JsonValue::KIND_STRING) {
+            if (primitiveType(value.string, type)) {
+                return addNode(type);
+            }
+            auto named = names.find(fullName(value.string, space));
+            if (named == names.end()) {
+                named = names.find(value.string);
+            }
+            if (named == names.end()) {
+                fail("unknown type '" + value.string + "'");
+            }
+            return named->second;
+        } else if (value.kind == JsonValue::KIND_ARRAY) {
+            size_t idx = addNode(TYPE_UNION);
+            for (const JsonValue &branch : value.items) {
+                size_t child = compile(branch, space);
+                nodes[idx].children.push_back(child);
+            }
+            if (nodes[idx].children.empty()) {
+                fail("union has no branch");
+            }
+            return idx;
+        } else if (value.kind != JsonValue::KIND_OBJECT) {
+            fail("type must be a string, an array or an object");
+        }
+
+        const JsonValue *typeValue = value.get("type");
+        if (typeValue == nullptr) {
+            fail("'type' is missing");
+        } else if (typeValue->kind != JsonValue::KIND_STRING) {
+            return compile(*typeValue, space);
+        }
+
+        const std::string &typeName = typeValue->string;
+        if (typeName == "record" || typeName == "error") {
+            size_t idx = addNode(TYPE_RECORD);
+            std::string memberSpace = defineName(value, space, idx);
+            for (const JsonValue &field : require(value, "fields", JsonValue::KIND_ARRAY).items) {
+                const std::string &name = require(field, "name", JsonValue::KIND_STRING).string;
+                const JsonValue *fieldType = field.get("type");
+                if (fieldType == nullptr) {
+                    fail("'type' of field '" + name + "' is missing");
+                }
+                size_t child = compile(*fieldType, memberSpace);
+                std::string label;
+                appendJsonString(label, name.data(), name.size());
+                label += ':';
+                nodes[idx].children.push_back(child);
+                nodes[idx].labels.push_back(label);
+            }
+            return idx;
+        } else if (typeName == "enum") {
+            size_t idx = addNode(TYPE_ENUM);
+            defineName(value, space, idx);
+            for (const JsonValue &symbol : require(value, "symbols", JsonValue::KIND_ARRAY).items) {
+                if (symbol.kind != JsonValue::KIND_STRING) {
+                    fail("symbol of enum must be a string");
+                }
+                std::string label;
+                appendJsonString(label, symbol.string.data(), symbol.string.size());
+                nodes[idx].labels.push_back(label);
+            }
+            return idx;
+        } else if (typeName == "fixed") {
+            size_t idx = addNode(TYPE_FIXED);
+            defineName(value, space, idx);
+            nodes[idx].size = strtoul(require(value, "size", JsonValue::KIND_NUMBER).string.c_str(), nullptr, 10);
+            return idx;
+        } else if (typeName == "array" || typeName == "map") {
+            size_t idx = addNode(typeName == "array" ? TYPE_ARRAY : TYPE_MAP);
+            const JsonValue *child = value.get(typeName == "array" ? "items" : "values");
+            if (child == nullptr) {
+                fail("'" + std::string(typeName == "array" ? "items" : "values") + "' is missing");
+            }
+            size_t childIdx = compile(*child, space);
+            nodes[idx].children.push_back(childIdx);
+            return idx;
+        } else if (primitiveType(typeName, type)) { // Including the primitive types with a logical type
+            return addNode(type);
+        }
+        return compile(*typeValue, space); // Named type
+    }
+};
+
+#endif // AVRO_SCHEMA_HPP
@@ -0,0 +1,177 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: KafkaAvroToJson : Decode Avro data in the Confluent wire format consumed from Apache Kafka into JSON data
+ *
+ * Create Date: March 15, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <exception>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "Vertica.h"
+
+#include "AvroDecoder.hpp"
+#include "RecordPrefix.hpp"
+#include "SchemaCache.hpp"
+
+using namespace Vertica;
+
+constexpr const char *DEBUG_PARAM = "debug";
+constexpr const char *SCHEMA_DIR_PARAM = "schemadir";
+
+/**
+ * KafkaAvroToJson : Filter class
+ */
+class KafkaAvroToJson : public UDFilter
+{
+    vbool debugFlag;                                               // debug flag
+    std::string schemaDir;                                         // Directory of the schema files
+    std::map<uint32_t, std::shared_ptr<const AvroSchema>> schemas; // Schemas used by this instance, to avoid locking the cache
+    std::string decoded;                                           // JSON of the current message
+    bool pending = false;                                          // The current message is decoded but not written yet
+    bool dropped = false;                                          // The current message is dropped
+
+public:
+
+    KafkaAvroToJson(vbool && debug_, std::string && schemaDir_) : debugFlag(std::move(debug_)), schemaDir(std::move(schemaDir_)) {}
+
+    bool useSideChannel() override
+    {
+        return true;
+    }
+
+    StreamState process(ServerInterface &srvInterface, DataBuffer &input, InputState input_state, DataBuffer &output) override
+    {
+        ereport(ERROR, (errmsg("process should not be called since processWithMetadata is defined."),
+                        errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE)));
+        return StreamState::DONE;
+    }
+
+    StreamState processWithMetadata(ServerInterface &srvInterface, DataBuffer &input, LengthBuffer &inputLengths, InputState inputState,
+                                    DataBuffer &output, LengthBuffer &outputLengths) override
+    {
+        if (inputLengths.offset == inputLengths.size) {
+            if (input.offset == input.size && inputState == END_OF_FILE) {
+                return DONE;
+            }
+            vt_report_error(0, "Input is not from a StreamSource");
+        }
+
+        while (inputLengths.offset < inputLengths.size) {
+            size_t record_len = inputLengths.buf[inputLengths.offset];
+            if (input.offset + record_len > input.size) {
+                VIAssert(inputState != END_OF_FILE);
+                return INPUT_NEEDED;
+            }
+
+            // The decoded message is kept until it fits in the output, so that it is decoded only once
+            if (!pending) {
+                decode(srvInterface, input.buf + input.offset, record_len);
+                pending = true;
+            }
+            if (!dropped) {
+                if (outputLengths.offset >= outputLengths.size || output.offset + decoded.size() > output.size) {
+                    debugLog(srvInterface, " OUTPUT_NEEDED returned. output size: %lu, offset: %lu, JSON length: %lu", output.size, output.offset, decoded.size());
+                    return OUTPUT_NEEDED;
+                }
+                memcpy(output.buf + output.offset, decoded.data(), decoded.size());
+                output.offset += decoded.size();
+                outputLengths.buf[outputLengths.offset] = decoded.size();
+                ++outputLengths.offset;
+            }
+            pending = false;
+
+            input.offset += record_len;
+            ++inputLengths.offset;
+        }
+
+        if (inputState != END_OF_FILE) {
+            return INPUT_NEEDED;
+        }
+
+        VIAssert(input.offset == input.size);
+        return DONE;
+    }
+
+    /*
+     * Decode the message into the JSON, or drop it if it has no header or is not valid for its schema.
+     */
+    void decode(ServerInterface &srvInterface, const char *record, size_t record_len)
+    {
+        decoded.clear();
+        dropped = true;
+        RecordPrefix prefix = RecordPrefixLocator(RecordPrefixLocator::WIRE_FORMAT_CONFLUENT).locate(record, record_len);
+        if (!prefix.hasSchemaId) {
+            debugLog(srvInterface, " message without the header is dropped. length: %lu", record_len);
+            return;
+        }
+
+        std::shared_ptr<const AvroSchema> &schema = schemas[prefix.schemaId];
+        if (!schema) {
+            schema = SchemaCache::get(srvInterface, schemaDir, prefix.schemaId);
+        }
+        bool valid;
+        try {
+            valid = AvroDecoder(*schema).decode(record + prefix.length, record_len - prefix.length, decoded);
+        } catch (const std::exception &e) { // Such as bad_alloc for a message which expands too much
+            debugLog(srvInterface, " message which fails to be decoded with schema ID %u is dropped. length: %lu, error: %s", prefix.schemaId, record_len, e.what());
+            std::string().swap(decoded); // Release the memory of the partial JSON
+            return;
+        }
+        if (!valid) {
+            debugLog(srvInterface, " message which is not valid for schema ID %u is dropped. length: %lu", prefix.schemaId, record_len);
+            return;
+        }
+        dropped = false;
+    }
+
+    /*
+     * Write a debug message to the log file.
+     */
+    void debugLog(ServerInterface &srvInterface, const char *format, ...)
+    {
+        if (debugFlag == vbool_true) {
+            va_list arg;
+            va_start(arg, format);
+            srvInterface.vlog(format, arg);
+            va_end(arg);
+        }
+    }
+};
+
+/**
+ * KafkaAvroToJsonFactory : Filter factory class
+ */
+class KafkaAvroToJsonFactory : public FilterFactory
+{
+    void getParameterType(ServerInterface &srvInterface, SizedColumnTypes &parameterTypes)
+    {
+        parameterTypes.addBool(DEBUG_PARAM, { false /* visible */, false /* required */, false /* canBeNull */, "Debug flag", false /* isSortedOnThis */ });
+        parameterTypes.addVarchar(1024, SCHEMA_DIR_PARAM, { true /* visible */, true /* required */, false /* canBeNull */,
+                                                            "Directory of the schema files named '<schema ID>.avsc'", false /* isSortedOnThis */ });
+    }
+
+    UDFilter* prepare(ServerInterface &srvInterface, PlanContext&) override
+    {
+        vbool debugFlag = vbool_false;
+        ParamReader paramReader = srvInterface.getParamReader();
+        if (paramReader.containsParameter(DEBUG_PARAM)) {
+            debugFlag = paramReader.getBoolRef(DEBUG_PARAM);
+        }
+        std::string schemaDir;
+        if (paramReader.containsParameter(SCHEMA_DIR_PARAM)) {
+            schemaDir = paramReader.getStringRef(SCHEMA_DIR_PARAM).str();
+        }
+        if (schemaDir.empty()) {
+            vt_report_error(0, "Filter only accepts that '%s' parameter is not empty", SCHEMA_DIR_PARAM);
+        }
+        return vt_createFuncObject<KafkaAvroToJson>(srvInterface.allocator, std::move(debugFlag), std::move(schemaDir));
+    }
+};
+
+// Register KafkaAvroToJson UDFilter.
+RegisterFactory(KafkaAvroToJsonFactory);
@@ -7,23 +7,39 @@
  * Author: Hibiki Serizawa
  */
 
+#include <chrono>
+#include <map>
+#include <string>
+
 #include "BuildInfo.h"
 #include "Vertica.h"
 
+#include "RecordStripper.hpp"
+
 using namespace Vertica;
 
 constexpr const char *DEBUG_PARAM = "debug";
+constexpr const char *WIRE_FORMAT_PARAM = "wireformat";
+constexpr const char *SCHEMA_ID_KEY_PARAM = "schemaidkey";
+constexpr const char *ARRAYS_PARAM = "arrays";
+constexpr const char *MAX_PREFIX_PARAM = "maxprefix";
 
 /**
  * KafkaRemoveMagicByte : Filter class
  */
 class KafkaRemoveMagicByte : public UDFilter
 {
-    vbool debugFlag; // debug flag
+    vbool debugFlag;                             // debug flag
+    RecordStripper stripper;                     // Copy the messages without their prefixes
+    uint64_t calls = 0;                          // Calls of processWithMetadata
+    uint64_t inputNeeded = 0;                    // INPUT_NEEDED returned
+    uint64_t outputNeeded = 0;                   // OUTPUT_NEEDED returned
+    std::chrono::steady_clock::duration elapsed; // Time spent in processWithMetadata
 
 public:
 
-    KafkaRemoveMagicByte(vbool && debug_) : debugFlag(std::move(debug_)) {}
+    KafkaRemoveMagicByte(vbool && debug_, const RecordPrefixLocator &locator, std::string && schemaIdKey)
+        : debugFlag(std::move(debug_)), stripper(locator, schemaIdKey), elapsed(0) {}
 
     bool useSideChannel() override
     {
@@ -37,58 +53,66 @@ public:
         return StreamState::DONE;
     }
 
+    /**
+     * Store the metrics of the stream to UDX_EVENTS once.
+     */
+    void destroy(ServerInterface &srvInterface) override
+    {
+        const RecordStripper::Metrics &metrics = stripper.getMetrics();
+        std::map<std::string, std::string> details;
+        details["filter"] = "KafkaRemoveMagicByte";
+        details["messages"] = std::to_string(metrics.messages);
+        details["messages_dropped"] = std::to_string(metrics.dropped);
+        details["bytes_in"] = std::to_string(metrics.bytesIn);
+        details["bytes_out"] = std::to_string(metrics.bytesOut);
+        details["bytes_stripped"] = std::to_string(metrics.bytesStripped);
+        details["calls"] = std::to_string(calls);
+        details["input_needed"] = std::to_string(inputNeeded);
+        details["output_needed"] = std::to_string(outputNeeded);
+        details["elapsed_us"] = std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        srvInterface.logEvent(details);
+    }
+
     StreamState processWithMetadata(ServerInterface &srvInterface, DataBuffer &input, LengthBuffer &inputLengths, InputState inputState,
                                     DataBuffer &output, LengthBuffer &outputLengths) override
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        StreamState state = processMessages(srvInterface, input, inputLengths, inputState, output, outputLengths);
+        elapsed += std::chrono::steady_clock::now() - start;
+        ++calls;
+        if (state == INPUT_NEEDED) {
+            ++inputNeeded;
+        } else if (state == OUTPUT_NEEDED) {
+            ++outputNeeded;
+        }
+        return state;
+    }
+
+    StreamState processMessages(ServerInterface &srvInterface, DataBuffer &input, LengthBuffer &inputLengths, InputState inputState,
+                                DataBuffer &output, LengthBuffer &outputLengths)
     {
         debugLog(srvInterface, "processWithMetadata starts");
         debugLog(srvInterface, " number of messages: %lu", inputLengths.size);
         debugLog(srvInterface, "   initial input size [%lu] offset [%lu]", input.size, input.offset);
         debugLog(srvInterface, "   initial output size [%lu] offset [%lu]", output.size, output.offset);
 
-        if (inputLengths.offset == inputLengths.size) {
-            if (input.offset == input.size && inputState == END_OF_FILE) {
-                return DONE;
-            }
+        // The output is filled as long as both the next message and its length fit, and the runs of messages
+        // without any prefix are copied with a single memcpy
+        switch (stripper.process(input, inputLengths, inputState == END_OF_FILE, output, outputLengths)) {
+        case RecordStripper::STEP_NOT_STREAM:
             vt_report_error(0, "Input is not from a StreamSource");
-        } else if (inputLengths.size > outputLengths.size) {
-            return OUTPUT_NEEDED;
-        }
-
-        while (inputLengths.offset < inputLengths.size) {
-            size_t record_len = inputLengths.buf[inputLengths.offset];
-            debugLog(srvInterface, " message offset: %lu, length: %lu", inputLengths.offset, record_len);
-
-            if (input.offset + record_len > input.size) {
-                VIAssert(inputState != END_OF_FILE);
-                debugLog(srvInterface, " INPUT_NEEDED returned. input size: %lu, offset: %lu, record length: %lu", input.size, input.offset, record_len);
-                return INPUT_NEEDED;
-            } else if (output.offset + record_len > output.size) {
-                debugLog(srvInterface, " OUTPUT_NEEDED returned. output size: %lu, offset: %lu, record length: %lu", output.size, output.offset, record_len);
-                return OUTPUT_NEEDED;
-            }
-
-            char *outbuf = output.buf + output.offset;
-            const char *p = input.buf + input.offset;
-            for (size_t i = 0; i < record_len; ++p, ++i) {
-                if (p[0] == '{') {
-                    memcpy(outbuf, p, record_len - i);
-                    output.offset += record_len - i;
-                    outputLengths.buf[outputLengths.offset] = record_len - i;
-                    ++outputLengths.offset;
-                    break;
-                }
-            }
-
-            input.offset += record_len;
-            ++inputLengths.offset;
-        }
-
-        if (inputState != END_OF_FILE) {
+            return DONE;
+        case RecordStripper::STEP_INPUT_NEEDED:
+            VIAssert(inputState != END_OF_FILE);
+            debugLog(srvInterface, " INPUT_NEEDED returned. input size: %lu, offset: %lu, message offset: %lu", input.size, input.offset, inputLengths.offset);
             return INPUT_NEEDED;
+        case RecordStripper::STEP_OUTPUT_NEEDED:
+            debugLog(srvInterface, " OUTPUT_NEEDED returned. output size: %lu, offset: %lu, message offset: %lu", output.size, output.offset, inputLengths.offset);
+            return OUTPUT_NEEDED;
+        default:
+            VIAssert(input.offset == input.size);
+            return DONE;
         }
-
-        VIAssert(input.offset == input.size);
-        return DONE;
     }
 
     /*
@@ -113,6 +137,14 @@ class KafkaRemoveMagicByteFactory : public FilterFactory
     void getParameterType(ServerInterface &srvInterface, SizedColumnTypes &parameterTypes)
     {
         parameterTypes.addBool(DEBUG_PARAM, { false /* visible */, false /* required */, false /* canBeNull */, "Debug flag", false /* isSortedOnThis */ });
+        parameterTypes.addVarchar(16, WIRE_FORMAT_PARAM, { true /* visible */, false /* required */, false /* canBeNull */,
+                                                           "Wire format of the messages: 'none' or 'confluent'", false /* isSortedOnThis */ });
+        parameterTypes.addVarchar(RecordStripper::MAX_SCHEMA_ID_KEY_LENGTH, SCHEMA_ID_KEY_PARAM, { true /* visible */, false /* required */, false /* canBeNull */,
+                                                                                                   "Key of the schema ID added to the JSON object", false /* isSortedOnThis */ });
+        parameterTypes.addBool(ARRAYS_PARAM, { true /* visible */, false /* required */, false /* canBeNull */,
+                                               "Flag to accept '[' as the start of JSON data", false /* isSortedOnThis */ });
+        parameterTypes.addInt(MAX_PREFIX_PARAM, { true /* visible */, false /* required */, false /* canBeNull */,
+                                                  "Max length of the data in front of JSON data", false /* isSortedOnThis */ });
     }
 
     UDFilter* prepare(ServerInterface &srvInterface, PlanContext&) override
@@ -122,7 +154,39 @@ class KafkaRemoveMagicByteFactory : public FilterFactory
         if (paramReader.containsParameter(DEBUG_PARAM)) {
             debugFlag = paramReader.getBoolRef(DEBUG_PARAM);
         }
-        return vt_createFuncObject<KafkaRemoveMagicByte>(srvInterface.allocator, std::move(debugFlag));
+        RecordPrefixLocator::WireFormat wireFormat = RecordPrefixLocator::WIRE_FORMAT_NONE;
+        if (paramReader.containsParameter(WIRE_FORMAT_PARAM)
+            && !RecordPrefixLocator::parseWireFormat(paramReader.getStringRef(WIRE_FORMAT_PARAM).str(), wireFormat)) {
+            vt_report_error(0, "Filter only accepts that '%s' parameter is 'none' or 'confluent'", WIRE_FORMAT_PARAM);
+        }
+        std::string schemaIdKey;
+        if (paramReader.containsParameter(SCHEMA_ID_KEY_PARAM)) {
+            schemaIdKey = paramReader.getStringRef(SCHEMA_ID_KEY_PARAM).str();
+            if (wireFormat != RecordPrefixLocator::WIRE_FORMAT_CONFLUENT) {
+                vt_report_error(0, "Filter only accepts '%s' parameter with %s='confluent'", SCHEMA_ID_KEY_PARAM, WIRE_FORMAT_PARAM);
+            }
+            if (schemaIdKey.length() > RecordStripper::MAX_SCHEMA_ID_KEY_LENGTH) {
+                vt_report_error(0, "Filter only accepts '%s' parameter up to %d characters", SCHEMA_ID_KEY_PARAM, RecordStripper::MAX_SCHEMA_ID_KEY_LENGTH);
+            }
+            for (char c : schemaIdKey) { // The key is written into JSON without escaping
+                if (c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20) {
+                    vt_report_error(0, "Filter only accepts '%s' parameter without quotes, backslashes and control characters", SCHEMA_ID_KEY_PARAM);
+                }
+            }
+        }
+
+        RecordPrefixLocator locator(wireFormat);
+        if (paramReader.containsParameter(ARRAYS_PARAM)) {
+            locator.setAcceptArrays(paramReader.getBoolRef(ARRAYS_PARAM) == vbool_true);
+        }
+        if (paramReader.containsParameter(MAX_PREFIX_PARAM)) {
+            vint maxPrefix = paramReader.getIntRef(MAX_PREFIX_PARAM);
+            if (maxPrefix < 0) {
+                vt_report_error(0, "Filter only accepts that '%s' parameter is 0 or a positive number", MAX_PREFIX_PARAM);
+            }
+            locator.setMaxPrefixLength(maxPrefix);
+        }
+        return vt_createFuncObject<KafkaRemoveMagicByte>(srvInterface.allocator, std::move(debugFlag), locator, std::move(schemaIdKey));
     }
 };
 
@@ -0,0 +1,245 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: RecordPrefix : Locate the JSON data behind the unexpected prefix of a Kafka message
+ *
+ * Create Date: March 15, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef RECORD_PREFIX_HPP
+#define RECORD_PREFIX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RECORD_PREFIX_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * RecordPrefix : Prefix of a message to be removed
+ */
+struct RecordPrefix
+{
+    bool found = false;         // JSON data is found, otherwise the message is dropped
+    size_t length = 0;          // Length of the prefix to be removed
+    bool hasSchemaId = false;   // The prefix is a header of the Confluent wire format
+    uint32_t schemaId = 0;      // Schema ID in the header
+};
+
+/**
+ * RecordPrefixLocator : Find the prefix of each message
+ *
+ * The start of JSON data is searched for 16 (SSE2) or 32 (AVX2) bytes at a time by comparing them with
+ * '{' and, if arrays are accepted, '['. The search is bounded by the maximum length of the prefix, so that
+ * a message without JSON data is not scanned to its end.
+ */
+class RecordPrefixLocator
+{
+
+public:
+    enum WireFormat {
+        WIRE_FORMAT_NONE,     // Scan for the first '{'
+        WIRE_FORMAT_CONFLUENT // Magic byte 0x00 and 4-byte big-endian schema ID, then scan when the magic byte is absent
+    };
+
+    enum Kernel { KERNEL_AUTO, KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX2 };
+
+    // Length of the header of the Confluent wire format
+    enum { CONFLUENT_HEADER_LENGTH = 5 };
+
+    /**
+     * Parse the name of the wire format, and return false if it is unknown.
+     */
+    static bool parseWireFormat(const std::string &name, WireFormat &wireFormat)
+    {
+        if (name == "none") {
+            wireFormat = WIRE_FORMAT_NONE;
+        } else if (name == "confluent") {
+            wireFormat = WIRE_FORMAT_CONFLUENT;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    explicit RecordPrefixLocator(WireFormat wireFormat_ = WIRE_FORMAT_NONE) : wireFormat(wireFormat_)
+    {
+        setKernel(KERNEL_AUTO);
+    }
+
+    /**
+     * Accept '[' as well as '{' as the start of JSON data.
+     */
+    void setAcceptArrays(bool acceptArrays)
+    {
+        arrayStart = acceptArrays ? '[' : '{';
+    }
+
+    /**
+     * Set the maximum length of the prefix. The message is dropped if JSON data does not start within it.
+     */
+    void setMaxPrefixLength(size_t maxPrefixLength_)
+    {
+        maxPrefixLength = maxPrefixLength_;
+    }
+
+    /**
+     * Select the search kernel. KERNEL_AUTO picks the widest one supported by the CPU.
+     * Returns false if the requested kernel is not available.
+     */
+    bool setKernel(Kernel requested)
+    {
+        Kernel selected = (requested == KERNEL_AUTO) ? bestKernel() : requested;
+        if (!isSupported(selected)) {
+            return false;
+        }
+        kernel = selected;
+        return true;
+    }
+
+    Kernel getKernel() const
+    {
+        return kernel;
+    }
+
+    /**
+     * Check if the kernel can run on this CPU.
+     */
+    static bool isSupported(Kernel k)
+    {
+        switch (k) {
+        case KERNEL_AUTO:
+        case KERNEL_SCALAR:
+            return true;
+#ifdef RECORD_PREFIX_X86
+        case KERNEL_SSE2:
+            return __builtin_cpu_supports("sse2");
+        case KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+        }
+    }
+
+    static const char *kernelName(Kernel k)
+    {
+        switch (k) {
+        case KERNEL_SCALAR:
+            return "scalar";
+        case KERNEL_SSE2:
+            return "sse2";
+        case KERNEL_AVX2:
+            return "avx2";
+        default:
+            return "auto";
+        }
+    }
+
+    /**
+     * Locate the prefix of the message.
+     */
+    RecordPrefix locate(const char *record, size_t length) const
+    {
+        RecordPrefix prefix;
+        if (wireFormat == WIRE_FORMAT_CONFLUENT && length >= CONFLUENT_HEADER_LENGTH && record[0] == 0x00) {
+            // The header has a fixed length, so the payload is not scanned
+            const unsigned char *id = reinterpret_cast<const unsigned char *>(record + 1);
+            prefix.found = true;
+            prefix.length = CONFLUENT_HEADER_LENGTH;
+            prefix.hasSchemaId = true;
+            prefix.schemaId = (static_cast<uint32_t>(id[0]) << 24) | (static_cast<uint32_t>(id[1]) << 16)
+                              | (static_cast<uint32_t>(id[2]) << 8) | static_cast<uint32_t>(id[3]);
+            return prefix;
+        }
+
+        // JSON data must start at or before maxPrefixLength
+        size_t limit = maxPrefixLength < length ? maxPrefixLength + 1 : length;
+        size_t pos = findJsonStart(record, limit);
+        if (pos < limit) {
+            prefix.found = true;
+            prefix.length = pos;
+        }
+        return prefix;
+    }
+
+    /**
+     * Return the position of the first '{' (or '[') in data[0, len), or len if there is none.
+     */
+    size_t findJsonStart(const char *data, size_t len) const
+    {
+#ifdef RECORD_PREFIX_X86
+        if (kernel == KERNEL_AVX2) {
+            return findJsonStartAVX2(data, len);
+        } else if (kernel == KERNEL_SSE2) {
+            return findJsonStartSSE2(data, 0, len);
+        }
+#endif
+        return findJsonStartScalar(data, 0, len);
+    }
+
+private:
+    WireFormat wireFormat;             // Wire format of the messages
+    char arrayStart = '{';             // '[' if arrays are accepted, or '{' to search only for objects
+    size_t maxPrefixLength = SIZE_MAX; // Maximum length of the prefix
+    Kernel kernel = KERNEL_SCALAR;     // Search kernel
+
+    static Kernel bestKernel()
+    {
+        if (isSupported(KERNEL_AVX2)) {
+            return KERNEL_AVX2;
+        } else if (isSupported(KERNEL_SSE2)) {
+            return KERNEL_SSE2;
+        }
+        return KERNEL_SCALAR;
+    }
+
+    size_t findJsonStartScalar(const char *data, size_t pos, size_t len) const
+    {
+        for ( ; pos < len; ++pos) {
+            if (data[pos] == '{' || data[pos] == arrayStart) {
+                return pos;
+            }
+        }
+        return len;
+    }
+
+#ifdef RECORD_PREFIX_X86
+    __attribute__((target("sse2")))
+    size_t findJsonStartSSE2(const char *data, size_t pos, size_t len) const
+    {
+        const __m128i object = _mm_set1_epi8('{');
+        const __m128i array = _mm_set1_epi8(arrayStart);
+        for ( ; pos + 16 <= len; pos += 16) {
+            __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+            int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(in, object), _mm_cmpeq_epi8(in, array)));
+            if (mask != 0) {
+                return pos + __builtin_ctz(mask);
+            }
+        }
+        return findJsonStartScalar(data, pos, len);
+    }
+
+    __attribute__((target("avx2")))
+    size_t findJsonStartAVX2(const char *data, size_t len) const
+    {
+        const __m256i object = _mm256_set1_epi8('{');
+        const __m256i array = _mm256_set1_epi8(arrayStart);
+        size_t pos = 0;
+        for ( ; pos + 32 <= len; pos += 32) {
+            __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(in, object), _mm256_cmpeq_epi8(in, array))));
+            if (mask != 0) {
+                return pos + __builtin_ctz(mask);
+            }
+        }
+        return findJsonStartSSE2(data, pos, len);
+    }
+#endif
+};
+
+#endif // RECORD_PREFIX_HPP
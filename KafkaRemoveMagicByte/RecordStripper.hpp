@@ -0,0 +1,278 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: RecordStripper : Remove the prefix of the Kafka messages from an input buffer into an output buffer
+ *
+ * Create Date: March 15, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef RECORD_STRIPPER_HPP
+#define RECORD_STRIPPER_HPP
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "RecordPrefix.hpp"
+
+/**
+ * RecordStripper : Copy the messages without their prefixes
+ *
+ * The buffers only need buf, size and offset members, so that Vertica's DataBuffer and LengthBuffer as well as
+ * the stand-ins of the offline tools can be used.
+ */
+class RecordStripper
+{
+
+public:
+    enum Status {
+        STATUS_CONSUMED,      // All messages in the input lengths are processed
+        STATUS_INPUT_NEEDED,  // The next message is not in the input buffer
+        STATUS_OUTPUT_NEEDED  // The next message does not fit in the output buffer
+    };
+
+    enum Step {
+        STEP_DONE,           // All input is processed and it is the end of the stream
+        STEP_INPUT_NEEDED,   // More input is needed
+        STEP_OUTPUT_NEEDED,  // The output buffer or the output lengths are full
+        STEP_NOT_STREAM      // The input has no lengths of the messages, which means it is not from a StreamSource
+    };
+
+    enum CopyMode {
+        COPY_PER_RECORD, // One memcpy per message
+        COPY_COALESCED   // One memcpy per run of contiguous messages without any change
+    };
+
+    // Maximum length of the schema ID key
+    enum { MAX_SCHEMA_ID_KEY_LENGTH = 128 };
+
+    // Number of messages processed in a batch
+    enum { BATCH_SIZE = 64 };
+
+    /**
+     * Metrics : Counters of the processed messages
+     */
+    struct Metrics {
+        uint64_t messages = 0;      // Messages processed
+        uint64_t dropped = 0;       // Messages dropped since JSON data is not found
+        uint64_t bytesIn = 0;       // Bytes of the processed messages
+        uint64_t bytesOut = 0;      // Bytes written to the output, including the schema ID members
+        uint64_t bytesStripped = 0; // Bytes of the removed prefixes, excluding the dropped messages
+    };
+
+    RecordStripper(const RecordPrefixLocator &locator_ = RecordPrefixLocator(), const std::string &schemaIdKey_ = "")
+        : locator(locator_), schemaIdKey(schemaIdKey_) {}
+
+    /**
+     * Counters since the stripper is created.
+     */
+    const Metrics &getMetrics() const
+    {
+        return metrics;
+    }
+
+    /**
+     * Select how the messages are copied. Only for the benchmark.
+     */
+    void setCopyMode(CopyMode copyMode_)
+    {
+        copyMode = copyMode_;
+    }
+
+    /**
+     * Decide the next step of the filter after processing the messages, as processWithMetadata does.
+     * endOfFile tells that no input follows the current input.
+     */
+    template <typename DataBufferT, typename LengthBufferT>
+    Step process(DataBufferT &input, LengthBufferT &inputLengths, bool endOfFile, DataBufferT &output, LengthBufferT &outputLengths)
+    {
+        if (inputLengths.offset == inputLengths.size) {
+            return (input.offset == input.size && endOfFile) ? STEP_DONE : STEP_NOT_STREAM;
+        }
+
+        switch (strip(input, inputLengths, output, outputLengths)) {
+        case STATUS_INPUT_NEEDED: // A message continues into the next input
+            return STEP_INPUT_NEEDED;
+        case STATUS_OUTPUT_NEEDED:
+            return STEP_OUTPUT_NEEDED;
+        default:
+            return endOfFile ? STEP_DONE : STEP_INPUT_NEEDED;
+        }
+    }
+
+    /**
+     * Process the messages from inputLengths.offset, and advance the offsets of the buffers.
+     *
+     * The messages are processed in batches. The prefixes of a batch are located first, and as many messages as
+     * fit in the output buffer and the output lengths are taken. Then they are copied with one memcpy per run of
+     * payloads which are contiguous in the input.
+     */
+    template <typename DataBufferT, typename LengthBufferT>
+    Status strip(DataBufferT &input, LengthBufferT &inputLengths, DataBufferT &output, LengthBufferT &outputLengths)
+    {
+        while (inputLengths.offset < inputLengths.size) {
+            Status status = locateBatch(input, inputLengths, output, outputLengths);
+            copyBatch(input, inputLengths, output, outputLengths);
+            if (status != STATUS_CONSUMED) {
+                return status;
+            }
+        }
+        return STATUS_CONSUMED;
+    }
+
+private:
+    RecordPrefixLocator locator;        // Locator of the prefix to be removed
+    std::string schemaIdKey;            // Key of the schema ID added to the JSON object, or empty not to add it
+    CopyMode copyMode = COPY_COALESCED; // How the messages are copied
+    Metrics metrics;                    // Counters of the processed messages
+
+    /**
+     * Segment : Output of a message in the batch
+     */
+    struct Segment {
+        size_t recordLength;  // Length of the message in the input
+        size_t prefixLength;  // Length of the removed prefix
+        const char *payload;  // Payload to be copied, or nullptr if the message is dropped
+        size_t payloadLength; // Length of the payload
+        size_t memberLength;  // Length of the schema ID member written in front of the payload
+        uint32_t schemaId;    // Schema ID in the header
+        bool emptyObject;     // The JSON object has no member
+    };
+    Segment batch[BATCH_SIZE]; // Messages taken in the current batch
+    size_t batchSize = 0;      // Number of messages in the batch
+
+    /**
+     * Locate the prefixes of the next messages, and take them into the batch while they fit in the output.
+     */
+    template <typename DataBufferT, typename LengthBufferT>
+    Status locateBatch(const DataBufferT &input, const LengthBufferT &inputLengths, const DataBufferT &output, const LengthBufferT &outputLengths)
+    {
+        size_t inputOffset = input.offset, outputOffset = output.offset, lengthsOffset = outputLengths.offset;
+        batchSize = 0;
+        for (size_t i = inputLengths.offset; i < inputLengths.size && batchSize < BATCH_SIZE; ++i) {
+            size_t record_len = inputLengths.buf[i];
+            if (inputOffset + record_len > input.size) {
+                return STATUS_INPUT_NEEDED;
+            }
+
+            const char *p = input.buf + inputOffset;
+            Segment &segment = batch[batchSize];
+            segment = Segment();
+            segment.recordLength = record_len;
+            RecordPrefix prefix = locator.locate(p, record_len);
+            if (prefix.found) {
+                segment.prefixLength = prefix.length;
+                segment.payload = p + prefix.length;
+                segment.payloadLength = record_len - prefix.length;
+
+                // The schema ID is added as the first member of the JSON object
+                if (prefix.hasSchemaId && !schemaIdKey.empty() && segment.payloadLength > 0 && segment.payload[0] == '{') {
+                    ++segment.payload;
+                    --segment.payloadLength;
+                    segment.schemaId = prefix.schemaId;
+                    segment.emptyObject = isEmptyObject(segment.payload, segment.payloadLength);
+                    segment.memberLength = memberLength(segment.schemaId, segment.emptyObject);
+                }
+
+                size_t out_len = segment.memberLength + segment.payloadLength;
+                if (lengthsOffset >= outputLengths.size || outputOffset + out_len > output.size) {
+                    return STATUS_OUTPUT_NEEDED;
+                }
+                outputOffset += out_len;
+                ++lengthsOffset;
+            }
+            inputOffset += record_len;
+            ++batchSize;
+        }
+        return STATUS_CONSUMED;
+    }
+
+    /**
+     * Copy the messages in the batch to the output, and advance the offsets of the buffers.
+     */
+    template <typename DataBufferT, typename LengthBufferT>
+    void copyBatch(DataBufferT &input, LengthBufferT &inputLengths, DataBufferT &output, LengthBufferT &outputLengths)
+    {
+        // Run of the payloads which are contiguous in the input, and which are not copied yet
+        const char *runStart = nullptr;
+        size_t runLength = 0;
+
+        for (size_t i = 0; i < batchSize; ++i) {
+            const Segment &segment = batch[i];
+            if (segment.payload != nullptr) {
+                if (segment.memberLength > 0) {
+                    flush(output, runStart, runLength);
+                    writeMember(output.buf + output.offset, segment.schemaId, segment.emptyObject);
+                    output.offset += segment.memberLength;
+                }
+                if (copyMode == COPY_COALESCED && runLength > 0 && runStart + runLength == segment.payload) {
+                    runLength += segment.payloadLength;
+                } else {
+                    flush(output, runStart, runLength);
+                    runStart = segment.payload;
+                    runLength = segment.payloadLength;
+                }
+                outputLengths.buf[outputLengths.offset++] = segment.memberLength + segment.payloadLength;
+                metrics.bytesOut += segment.memberLength + segment.payloadLength;
+                metrics.bytesStripped += segment.prefixLength;
+            } else {
+                ++metrics.dropped;
+            }
+            input.offset += segment.recordLength;
+            metrics.bytesIn += segment.recordLength;
+        }
+        metrics.messages += batchSize;
+        flush(output, runStart, runLength);
+        inputLengths.offset += batchSize;
+    }
+
+    /**
+     * Copy the run of messages to the output with a single memcpy.
+     */
+    template <typename DataBufferT>
+    static void flush(DataBufferT &output, const char *runStart, size_t &runLength)
+    {
+        if (runLength > 0) {
+            memcpy(output.buf + output.offset, runStart, runLength);
+            output.offset += runLength;
+            runLength = 0;
+        }
+    }
+
+    /**
+     * Check if the rest of the JSON object after '{' has no member.
+     */
+    static bool isEmptyObject(const char *rest, size_t rest_len)
+    {
+        size_t i = 0;
+        while (i < rest_len && (rest[i] == ' ' || rest[i] == '\t' || rest[i] == '\n' || rest[i] == '\r')) {
+            ++i;
+        }
+        return i < rest_len && rest[i] == '}';
+    }
+
+    /**
+     * Length of '{"key":schemaId' and a comma unless the object is empty.
+     */
+    size_t memberLength(uint32_t schemaId, bool emptyObject) const
+    {
+        size_t digits = 1;
+        for (uint32_t n = schemaId; n >= 10; n /= 10) {
+            ++digits;
+        }
+        return 4 + schemaIdKey.length() + digits + (emptyObject ? 0 : 1);
+    }
+
+    /**
+     * Write '{"key":schemaId' and a comma unless the object is empty, which replace '{' of the JSON object.
+     */
+    void writeMember(char *out, uint32_t schemaId, bool emptyObject) const
+    {
+        char member[MAX_SCHEMA_ID_KEY_LENGTH + 32];
+        size_t length = snprintf(member, sizeof(member), "{\"%s\":%u%s", schemaIdKey.c_str(), schemaId, emptyObject ? "" : ",");
+        memcpy(out, member, length);
+    }
+};
+
+#endif // RECORD_STRIPPER_HPP
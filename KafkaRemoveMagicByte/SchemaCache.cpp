@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: SchemaCache : Process-wide cache of the compiled Avro schemas
+ *
+ * Create Date: March 15, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include "Vertica.h"
+#include "SchemaCache.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+mutex SchemaCache::lock;
+map<string, shared_ptr<const AvroSchema>> SchemaCache::entries;
+
+/**
+ * Get the compiled schema of the schema ID. The schema file is read and compiled only at the first time,
+ * and the lock is held only to look up and publish the entry.
+ */
+shared_ptr<const AvroSchema> SchemaCache::get(ServerInterface &srvInterface, const string &directory, uint32_t schemaId)
+{
+    string path = directory + "/" + to_string(schemaId) + ".avsc";
+
+    {
+        lock_guard<mutex> guard(lock);
+        map<string, shared_ptr<const AvroSchema>>::iterator it = entries.find(path);
+        if (it != entries.end()) {
+            return it->second;
+        }
+    }
+
+    // The file is read and compiled without the lock, so that the other schema IDs are not blocked
+    ifstream file(path.c_str());
+    if (!file) {
+        vt_report_error(0, "The schema file [%s] of schema ID %u does not exist", path.c_str(), schemaId);
+    }
+    stringstream contents;
+    contents << file.rdbuf();
+
+    shared_ptr<const AvroSchema> schema;
+    try {
+        schema = make_shared<const AvroSchema>(contents.str());
+    } catch (exception &e) {
+        vt_report_error(0, "Invalid schema in the schema file [%s]: %s", path.c_str(), e.what());
+    }
+
+    // Another instance may have compiled the same schema in the meantime, and the first one is shared
+    lock_guard<mutex> guard(lock);
+    shared_ptr<const AvroSchema> &entry = entries[path];
+    if (!entry) {
+        srvInterface.log("KafkaAvroToJson: compiled schema [%s]", path.c_str());
+        entry = schema;
+    }
+    return entry;
+}
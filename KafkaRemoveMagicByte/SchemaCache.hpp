@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: SchemaCache : Header file of SchemaCache.cpp
+ *
+ * Create Date: March 15, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef SCHEMA_CACHE_HPP
+#define SCHEMA_CACHE_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "Vertica.h"
+#include "AvroSchema.hpp"
+
+/**
+ * SchemaCache : Process-wide cache of the compiled Avro schemas shared by all instances
+ *
+ * An entry is keyed by the path of the schema file '<directory>/<schema ID>.avsc'. A schema registry never
+ * changes the schema of an ID, so an entry is compiled once and never invalidated.
+ */
+class SchemaCache
+{
+
+public:
+    static std::shared_ptr<const AvroSchema> get(Vertica::ServerInterface &srvInterface, const std::string &directory, uint32_t schemaId);
+
+private:
+    static std::mutex lock;
+    static std::map<std::string, std::shared_ptr<const AvroSchema>> entries;
+};
+
+#endif // SCHEMA_CACHE_HPP
@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Benchmark of RecordStripper with per-message copies and coalesced copies, and of RecordPrefixLocator kernels
+ *
+ * Create Date: March 15, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../RecordStripper.hpp"
+
+using namespace std;
+
+/**
+ * Stand-ins of DataBuffer and LengthBuffer
+ */
+struct BenchDataBuffer {
+    char *buf;
+    size_t size;
+    size_t offset;
+};
+struct BenchLengthBuffer {
+    size_t *buf;
+    size_t size;
+    size_t offset;
+};
+
+/**
+ * Generate JSON messages whose lengths are uniformly distributed in [16, 2 * meanLength].
+ * Every headerInterval-th message has the header of the Confluent wire format, and 0 means no header.
+ */
+static void generate(size_t totalBytes, size_t meanLength, size_t headerInterval, string &data, vector<size_t> &lengths, mt19937 &rng)
+{
+    data.clear();
+    lengths.clear();
+    while (data.size() < totalBytes) {
+        size_t start = data.size();
+        if (headerInterval > 0 && lengths.size() % headerInterval == 0) {
+            data += string("\x00\x00\x00\x00\x07", 5);
+        }
+        size_t length = 16 + rng() % (2 * meanLength - 15);
+        data += "{\"v\":\"";
+        for (size_t i = 8; i < length; ++i) {
+            data += static_cast<char>('a' + rng() % 26);
+        }
+        data += "\"}";
+        lengths.push_back(data.size() - start);
+    }
+}
+
+/**
+ * Strip all messages into a 1 MB output buffer, which is consumed whenever it is full, and return the output bytes.
+ */
+static size_t run(RecordStripper &stripper, string &data, vector<size_t> &lengths)
+{
+    vector<char> out(1 << 20);
+    vector<size_t> outLengths(lengths.size());
+    BenchDataBuffer input = {&data[0], data.size(), 0};
+    BenchLengthBuffer inputLengths = {lengths.data(), lengths.size(), 0};
+    BenchDataBuffer output = {out.data(), out.size(), 0};
+    BenchLengthBuffer outputLengths = {outLengths.data(), outLengths.size(), 0};
+
+    size_t bytes = 0;
+    while (stripper.strip(input, inputLengths, output, outputLengths) == RecordStripper::STATUS_OUTPUT_NEEDED) {
+        bytes += output.offset;
+        output.offset = 0;
+        outputLengths.offset = 0;
+    }
+    return bytes + output.offset;
+}
+
+/**
+ * Measure the search of the JSON start over messages with a prefix whose length is uniformly distributed in [0, 2 * meanPrefix].
+ */
+static void runLocator(size_t meanPrefix, int iterations, mt19937 &rng)
+{
+    vector<string> records(1 << 18);
+    size_t bytes = 0;
+    for (string &record : records) {
+        size_t length = rng() % (2 * meanPrefix + 1);
+        for (size_t i = 0; i < length; ++i) {
+            record += static_cast<char>('a' + rng() % 26);
+        }
+        record += "{\"v\":1}";
+        bytes += record.size();
+    }
+
+    size_t expected = 0;
+    for (RecordPrefixLocator::Kernel kernel : {RecordPrefixLocator::KERNEL_SCALAR, RecordPrefixLocator::KERNEL_SSE2, RecordPrefixLocator::KERNEL_AVX2}) {
+        RecordPrefixLocator locator;
+        if (!locator.setKernel(kernel)) {
+            continue;
+        }
+        locator.setAcceptArrays(true);
+        size_t found = 0;
+        double sec = 0;
+        for (int i = 0; i < iterations; ++i) {
+            auto start = chrono::steady_clock::now();
+            for (const string &record : records) {
+                found += locator.locate(record.data(), record.size()).length;
+            }
+            double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            sec = (i == 0 || elapsed < sec) ? elapsed : sec;
+        }
+        if (found != expected && kernel != RecordPrefixLocator::KERNEL_SCALAR) {
+            fprintf(stderr, "FAIL prefix lengths %zu != %zu\n", found, expected);
+            exit(1);
+        }
+        expected = found;
+        printf("%-12zu %-12s %10.0f %14.0f\n", meanPrefix, RecordPrefixLocator::kernelName(kernel),
+               static_cast<double>(bytes) / sec / 1e6, records.size() / sec);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 5;
+    mt19937 rng(1);
+    string data;
+    vector<size_t> lengths;
+
+    printf("%-12s %-12s %-12s %10s %14s\n", "header", "mean length", "copy", "MB/s", "msgs/s");
+    for (size_t headerInterval : {0, 16, 1}) {
+        for (size_t meanLength : {64, 256, 1024}) {
+            generate(64 << 20, meanLength, headerInterval, data, lengths, rng);
+            size_t expected = 0;
+            for (RecordStripper::CopyMode copyMode : {RecordStripper::COPY_PER_RECORD, RecordStripper::COPY_COALESCED}) {
+                RecordStripper stripper(RecordPrefixLocator(RecordPrefixLocator::WIRE_FORMAT_CONFLUENT));
+                stripper.setCopyMode(copyMode);
+                size_t bytes = 0;
+                double sec = 0;
+                for (int i = 0; i < iterations; ++i) { // The best time is taken, since the others are disturbed by the other processes
+                    auto start = chrono::steady_clock::now();
+                    bytes = run(stripper, data, lengths);
+                    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                    sec = (i == 0 || elapsed < sec) ? elapsed : sec;
+                }
+                if (copyMode == RecordStripper::COPY_PER_RECORD) {
+                    expected = bytes;
+                } else if (bytes != expected) {
+                    fprintf(stderr, "FAIL output bytes %zu != %zu\n", bytes, expected);
+                    return 1;
+                }
+                printf("%-12s %-12zu %-12s %10.0f %14.0f\n",
+                       headerInterval == 0 ? "none" : headerInterval == 1 ? "all" : "1/16", meanLength,
+                       copyMode == RecordStripper::COPY_PER_RECORD ? "per-record" : "coalesced",
+                       static_cast<double>(data.size()) / sec / 1e6, lengths.size() / sec);
+            }
+        }
+    }
+
+    printf("\n%-12s %-12s %10s %14s\n", "mean prefix", "kernel", "MB/s", "msgs/s");
+    for (size_t meanPrefix : {8, 32, 128, 512}) {
+        runLocator(meanPrefix, iterations, rng);
+    }
+    return 0;
+}
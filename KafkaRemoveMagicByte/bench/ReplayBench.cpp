@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Benchmark of RecordStripper replaying recorded or generated messages with the buffer boundaries of a StreamSource
+ *
+ * Create Date: March 15, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../cpptest/ReplayHarness.hpp"
+
+using namespace std;
+
+/**
+ * Generate 64 MB of JSON messages with the header of the Confluent wire format, whose lengths are uniformly
+ * distributed in [16, 512].
+ */
+static vector<string> generate(mt19937 &rng)
+{
+    vector<string> messages;
+    size_t bytes = 0;
+    while (bytes < (64 << 20)) {
+        string message("\x00\x00\x00\x00\x07{\"v\":\"", 11);
+        size_t length = 16 + rng() % 497;
+        while (message.size() < length - 2) {
+            message += static_cast<char>('a' + rng() % 26);
+        }
+        message += "\"}";
+        bytes += message.size();
+        messages.push_back(message);
+    }
+    return messages;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *recording = argc > 1 && strcmp(argv[1], "-") != 0 ? argv[1] : nullptr;
+    int iterations = argc > 2 ? atoi(argv[2]) : 5;
+    mt19937 rng(1);
+
+    vector<string> messages;
+    if (recording == nullptr) {
+        messages = generate(rng);
+    } else if (!ReplayHarness::readRecording(recording, messages)) {
+        fprintf(stderr, "Failed to read %s\n", recording);
+        return 1;
+    }
+    ReplayHarness harness(messages);
+    printf("%zu messages, %zu bytes from %s\n\n", harness.messages(), harness.bytes(), recording == nullptr ? "generated data" : recording);
+
+    // Input and output buffers from 4 KB to 64 KB, and from 256 KB to 1 MB
+    struct Profile {
+        const char *name;
+        size_t minBuffer;
+        size_t maxBuffer;
+        size_t maxLengths;
+    };
+    const Profile profiles[] = {{"small", 4 << 10, 64 << 10, 256}, {"large", 256 << 10, 1 << 20, 8192}};
+
+    printf("%-8s %-12s %-10s %10s %14s %10s %12s %12s\n", "buffers", "wireformat", "schemaid", "MB/s", "msgs/s", "calls", "input", "output");
+    for (const Profile &profile : profiles) {
+        for (int config = 0; config < 3; ++config) {
+            RecordPrefixLocator locator(config == 0 ? RecordPrefixLocator::WIRE_FORMAT_NONE : RecordPrefixLocator::WIRE_FORMAT_CONFLUENT);
+            string schemaIdKey = config == 2 ? "schema_id" : "";
+            ReplayResult expected = ReplayHarness::reference(locator, schemaIdKey, messages);
+
+            ReplayOptions options;
+            options.minInput = options.minOutput = profile.minBuffer;
+            options.maxInput = options.maxOutput = profile.maxBuffer;
+            options.maxInputLengths = options.maxOutputLengths = profile.maxLengths;
+            options.minOutputLengths = profile.maxLengths / 4;
+
+            ReplayResult result;
+            double sec = 0;
+            for (int i = 0; i < iterations; ++i) { // The best time is taken, since the others are disturbed by the other processes
+                RecordStripper stripper(locator, schemaIdKey);
+                mt19937 bufferRng(2);
+                result = harness.replay(stripper, options, bufferRng);
+                double elapsed = chrono::duration<double>(result.elapsed).count();
+                sec = (i == 0 || elapsed < sec) ? elapsed : sec;
+            }
+            if (!result.error.empty() || result.output != expected.output || result.lengths != expected.lengths) {
+                fprintf(stderr, "FAIL %s: %s\n", profile.name, result.error.empty() ? "output differs" : result.error.c_str());
+                return 1;
+            }
+            printf("%-8s %-12s %-10s %10.0f %14.0f %10llu %12llu %12llu\n", profile.name, config == 0 ? "none" : "confluent",
+                   schemaIdKey.empty() ? "-" : schemaIdKey.c_str(), static_cast<double>(harness.bytes()) / sec / 1e6, harness.messages() / sec,
+                   static_cast<unsigned long long>(result.calls), static_cast<unsigned long long>(result.inputNeeded),
+                   static_cast<unsigned long long>(result.outputNeeded));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Test of AvroSchema and AvroDecoder with data encoded by hand
+ *
+ * Create Date: March 15, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "../AvroDecoder.hpp"
+
+using namespace std;
+
+/**
+ * Encoder of the Avro binary data
+ */
+struct Encoder {
+    string data;
+
+    Encoder &putLong(int64_t value)
+    {
+        uint64_t n = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        while (n >= 0x80) {
+            data += static_cast<char>((n & 0x7F) | 0x80);
+            n >>= 7;
+        }
+        data += static_cast<char>(n);
+        return *this;
+    }
+
+    Encoder &putString(const string &value)
+    {
+        putLong(value.size());
+        data += value;
+        return *this;
+    }
+
+    Encoder &putDouble(double value)
+    {
+        char buf[8];
+        memcpy(buf, &value, 8);
+        data.append(buf, 8);
+        return *this;
+    }
+
+    Encoder &putFloat(float value)
+    {
+        char buf[4];
+        memcpy(buf, &value, 4);
+        data.append(buf, 4);
+        return *this;
+    }
+};
+
+static size_t failures = 0, cases = 0;
+
+static void check(const char *label, const AvroSchema &schema, const string &data, bool expectedResult, const string &expected)
+{
+    string json;
+    bool result = AvroDecoder(schema).decode(data.data(), data.size(), json);
+    ++cases;
+    if (result != expectedResult || (result && json != expected)) {
+        fprintf(stderr, "FAIL %s: %d %s\n", label, result, json.c_str());
+        ++failures;
+    }
+}
+
+int main()
+{
+    AvroSchema user(R"({"type": "record", "name": "User", "namespace": "example",
+        "fields": [
+            {"name": "id", "type": "long"},
+            {"name": "name", "type": "string"},
+            {"name": "active", "type": "boolean"},
+            {"name": "tags", "type": {"type": "array", "items": "string"}},
+            {"name": "attrs", "type": {"type": "map", "values": "int"}},
+            {"name": "color", "type": {"type": "enum", "name": "Color", "symbols": ["RED", "GREEN"]}},
+            {"name": "score", "type": "double"},
+            {"name": "ratio", "type": "float"},
+            {"name": "hash", "type": {"type": "fixed", "name": "Hash", "size": 2}},
+            {"name": "created", "type": {"type": "long", "logicalType": "timestamp-millis"}},
+            {"name": "next", "type": ["null", "example.User"]}
+        ]})");
+
+    Encoder inner;
+    inner.putLong(-2).putString("").data += '\x00';                      // id, name, active
+    inner.putLong(0).putLong(0).putLong(1);                              // tags, attrs, color
+    inner.putDouble(0.0).putFloat(0.5f);                                 // score, ratio
+    inner.data += string("\x00\xff", 2);                                 // hash
+    inner.putLong(0).putLong(0);                                         // created, next
+    Encoder outer;
+    outer.putLong(1).putString("bob \"b\"").data += '\x01';              // id, name, active
+    outer.putLong(2).putString("a").putString("b").putLong(0);           // tags in a block
+    outer.putLong(-1).putLong(2).putString("k").putLong(42).putLong(0);  // attrs in a block with its size
+    outer.putLong(0).putDouble(1.5).putFloat(-2.0f);                     // color, score, ratio
+    outer.data += "ab";                                                  // hash
+    outer.putLong(1700000000000LL).putLong(1);                           // created, next
+    outer.data += inner.data;
+
+    const string innerJson = R"({"id":-2,"name":"","active":false,"tags":[],"attrs":{},"color":"GREEN","score":0,"ratio":0.5,)"
+                             R"("hash":"\u0000\u00ff","created":0,"next":null})";
+    check("record", user, outer.data, true,
+          R"({"id":1,"name":"bob \"b\"","active":true,"tags":["a","b"],"attrs":{"k":42},"color":"RED","score":1.5,"ratio":-2,)"
+          R"("hash":"ab","created":1700000000000,"next":)" + innerJson + "}");
+
+    // Malformed data
+    check("truncated", user, outer.data.substr(0, outer.data.size() - 1), false, "");
+    check("extra bytes", user, outer.data + "x", false, "");
+    Encoder badEnum;
+    badEnum.putLong(5);
+    AvroSchema color(R"({"type": "enum", "name": "Color", "symbols": ["RED", "GREEN"]})");
+    check("enum out of range", color, badEnum.data, false, "");
+    Encoder badString;
+    badString.putLong(100).data += "short";
+    check("string too long", AvroSchema(R"("string")"), badString.data, false, "");
+
+    // Block counts which do not fit in the data
+    AvroSchema nulls(R"({"type": "array", "items": "null"})");
+    Encoder hugeNulls;
+    hugeNulls.putLong(1LL << 40).putLong(0);
+    check("huge count of null items", nulls, hugeNulls.data, false, "");
+    Encoder minCount;
+    minCount.putLong(INT64_MIN).putLong(0).putLong(0);
+    check("minimum negative count", nulls, minCount.data, false, "");
+    Encoder fewNulls;
+    fewNulls.putLong(3).putLong(-2).putLong(0).putLong(0);
+    check("null items", nulls, fewNulls.data, true, "[null,null,null,null,null]");
+    AvroSchema empties(R"({"type": "array", "items": {"type": "record", "name": "Empty", "fields": []}})");
+    check("huge count of empty records", empties, hugeNulls.data, false, "");
+    AvroSchema nullRecords(R"({"type": "array", "items": {"type": "record", "name": "N", "fields": [
+        {"name": "a", "type": "null"}, {"name": "b", "type": {"type": "fixed", "name": "F", "size": 0}}]}})");
+    check("huge count of records of null and empty fixed", nullRecords, hugeNulls.data, false, "");
+    check("records of null and empty fixed", nullRecords, fewNulls.data.substr(0, 1) + string(1, '\0'), true,
+          R"([{"a":null,"b":""},{"a":null,"b":""},{"a":null,"b":""}])");
+    AvroSchema longs(R"({"type": "array", "items": "long"})");
+    Encoder hugeLongs;
+    hugeLongs.putLong(1000).putLong(1).putLong(0);
+    check("count beyond the data", longs, hugeLongs.data, false, "");
+    AvroSchema nested(R"({"type": "array", "items": {"type": "array", "items": "null"}})");
+    Encoder nestedNulls;
+    for (int i = 0; i < 3; ++i) {
+        nestedNulls.putLong(1).putLong(1 << 19).putLong(0);
+    }
+    nestedNulls.putLong(0);
+    check("empty items over the limit in a datum", nested, nestedNulls.data, false, "");
+
+    // Primitive schemas and escapes
+    Encoder text;
+    text.putString(string("a\nb\x01\\", 5));
+    check("string escape", AvroSchema(R"({"type": "string"})"), text.data, true, R"("a\u000ab\u0001\\")");
+    Encoder nan;
+    nan.putDouble(NAN);
+    check("nan", AvroSchema(R"("double")"), nan.data, true, "null");
+    Encoder branch;
+    branch.putLong(1).putLong(-64);
+    check("union", AvroSchema(R"(["null", "int"])"), branch.data, true, "-64");
+
+    // Invalid schemas
+    const char *invalidSchemas[] = {
+        R"({"type": "record", "name": "A", "fields": [{"name": "x", "type": "B"}]})",
+        R"({"type": "record", "fields": []})",
+        R"({"type": "array"})",
+        R"([])",
+        R"({"type": "string")",
+    };
+    for (const char *invalid : invalidSchemas) {
+        ++cases;
+        try {
+            AvroSchema schema(invalid);
+            fprintf(stderr, "FAIL invalid schema is accepted: %s\n", invalid);
+            ++failures;
+        } catch (const invalid_argument &) {
+        }
+    }
+
+    printf("%s: %zu cases, %zu failures\n", failures == 0 ? "PASS" : "FAIL", cases, failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Test of RecordPrefixLocator kernels against the scalar search
+ *
+ * Create Date: March 15, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../RecordPrefix.hpp"
+
+using namespace std;
+
+/**
+ * Find the prefix one byte at a time.
+ */
+static RecordPrefix reference(const string &record, bool arrays, size_t maxPrefix)
+{
+    RecordPrefix prefix;
+    for (size_t i = 0; i < record.size() && i <= maxPrefix; ++i) {
+        if (record[i] == '{' || (arrays && record[i] == '[')) {
+            prefix.found = true;
+            prefix.length = i;
+            break;
+        }
+    }
+    return prefix;
+}
+
+int main()
+{
+    size_t failures = 0, cases = 0;
+    mt19937 rng(20240315);
+    const string alphabet("ab{[\x00\xfb\xdb", 7); // 0xfb and 0xdb differ from '{' and '[' only in the top bit
+
+    vector<RecordPrefixLocator::Kernel> kernels;
+    for (RecordPrefixLocator::Kernel kernel : {RecordPrefixLocator::KERNEL_SCALAR, RecordPrefixLocator::KERNEL_SSE2, RecordPrefixLocator::KERNEL_AVX2}) {
+        if (RecordPrefixLocator::isSupported(kernel)) {
+            kernels.push_back(kernel);
+        }
+    }
+
+    for (int round = 0; round < 100000; ++round) {
+        // Few JSON starts placed around the 16 and 32-byte boundaries of a record of up to 200 bytes
+        size_t len = rng() % 200;
+        string record(len, 'x');
+        for (size_t i = 0; i < len; ++i) {
+            if (rng() % 8 == 0) {
+                record[i] = alphabet[rng() % alphabet.size()];
+            }
+        }
+        if (len > 0 && rng() % 2 == 0) {
+            size_t boundary = (rng() % 2 == 0 ? 16 : 32) * (1 + rng() % 6) + rng() % 3 - 1;
+            if (boundary < len) {
+                record[boundary] = rng() % 2 == 0 ? '{' : '[';
+            }
+        }
+        bool arrays = rng() % 2 == 0;
+        size_t maxPrefix = rng() % 3 == 0 ? SIZE_MAX : rng() % 210;
+        RecordPrefix expected = reference(record, arrays, maxPrefix);
+
+        // The record is copied into a buffer of its exact size at a random alignment, so that any over-read is caught
+        // by AddressSanitizer when the test is built with 'make cpptest-asan'
+        size_t shift = rng() % 32;
+        vector<char> storage(shift + len);
+        if (len > 0) {
+            memcpy(storage.data() + shift, record.data(), len);
+        }
+
+        for (RecordPrefixLocator::Kernel kernel : kernels) {
+            RecordPrefixLocator locator;
+            locator.setKernel(kernel);
+            locator.setAcceptArrays(arrays);
+            locator.setMaxPrefixLength(maxPrefix);
+            RecordPrefix prefix = locator.locate(storage.data() + shift, len);
+            ++cases;
+            if (prefix.found != expected.found || prefix.length != expected.length) {
+                fprintf(stderr, "FAIL kernel=%s length=%zu arrays=%d maxprefix=%zu: %d %zu, expected %d %zu\n",
+                        RecordPrefixLocator::kernelName(kernel), len, arrays, maxPrefix, prefix.found, prefix.length, expected.found, expected.length);
+                ++failures;
+            }
+        }
+    }
+
+    // Confluent wire format
+    RecordPrefixLocator confluent(RecordPrefixLocator::WIRE_FORMAT_CONFLUENT);
+    const string header("\x00\x00\x01\x00\x7b", 5); // The schema ID 65659 has '{' in its last byte
+    RecordPrefix prefix = confluent.locate((header + "[1]").data(), 8);
+    ++cases;
+    if (!prefix.found || prefix.length != 5 || !prefix.hasSchemaId || prefix.schemaId != 65659) {
+        fprintf(stderr, "FAIL confluent header\n");
+        ++failures;
+    }
+    prefix = confluent.locate("ab{}", 4);
+    ++cases;
+    if (!prefix.found || prefix.length != 2 || prefix.hasSchemaId) {
+        fprintf(stderr, "FAIL confluent fallback\n");
+        ++failures;
+    }
+    confluent.setMaxPrefixLength(1);
+    prefix = confluent.locate("ab{}", 4);
+    ++cases;
+    if (prefix.found) {
+        fprintf(stderr, "FAIL confluent fallback beyond maxprefix\n");
+        ++failures;
+    }
+
+    printf("%s: %zu cases, %zu failures (kernels:", failures == 0 ? "PASS" : "FAIL", cases, failures);
+    for (RecordPrefixLocator::Kernel kernel : kernels) {
+        printf(" %s", RecordPrefixLocator::kernelName(kernel));
+    }
+    printf(")\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,243 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: ReplayHarness : Replay Kafka messages through RecordStripper with the buffer boundaries of a StreamSource
+ *
+ * Create Date: March 15, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef REPLAY_HARNESS_HPP
+#define REPLAY_HARNESS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../RecordStripper.hpp"
+
+/**
+ * Stand-ins of DataBuffer and LengthBuffer
+ */
+struct ReplayDataBuffer {
+    char *buf;
+    size_t size;
+    size_t offset;
+};
+struct ReplayLengthBuffer {
+    size_t *buf;
+    size_t size;
+    size_t offset;
+};
+
+/**
+ * ReplayOptions : Ranges of the buffer sizes, which are chosen at random for every call
+ */
+struct ReplayOptions {
+    size_t minInput = 1;          // Min bytes added to the input buffer when INPUT_NEEDED is returned
+    size_t maxInput = 64;         // Max bytes added to the input buffer when INPUT_NEEDED is returned
+    size_t maxInputLengths = 8;   // Max number of message lengths in the input
+    size_t minOutput = 1;         // Min size of the output buffer
+    size_t maxOutput = 64;        // Max size of the output buffer
+    size_t minOutputLengths = 1;  // Min number of message lengths in the output
+    size_t maxOutputLengths = 8;  // Max number of message lengths in the output
+};
+
+/**
+ * ReplayResult : Output of the filter and the transitions
+ */
+struct ReplayResult {
+    std::string output;                            // Concatenated output
+    std::vector<size_t> lengths;                   // Lengths of the output messages
+    uint64_t calls = 0;                            // Calls of the filter
+    uint64_t inputNeeded = 0;                      // INPUT_NEEDED returned
+    uint64_t outputNeeded = 0;                     // OUTPUT_NEEDED returned
+    std::chrono::steady_clock::duration elapsed{}; // Time spent in the filter
+    std::string error;                             // Protocol violation, or empty
+};
+
+/**
+ * ReplayHarness : Drive the filter like Vertica does for a StreamSource
+ *
+ * The unprocessed input is kept and more input is appended when INPUT_NEEDED is returned, so a message may be split
+ * at any byte. The lengths of the messages are given only for the messages whose first byte is in the input, and
+ * at most maxInputLengths at a time. The output is consumed after every call, and the output buffer is doubled
+ * when nothing fits in it, as Vertica does for a large message.
+ */
+class ReplayHarness
+{
+
+public:
+    explicit ReplayHarness(const std::vector<std::string> &messages)
+    {
+        for (const std::string &message : messages) {
+            starts.push_back(data.size());
+            lengths.push_back(message.size());
+            data += message;
+        }
+    }
+
+    size_t bytes() const
+    {
+        return data.size();
+    }
+
+    size_t messages() const
+    {
+        return lengths.size();
+    }
+
+    /**
+     * Replay all messages through the stripper.
+     */
+    ReplayResult replay(RecordStripper &stripper, const ReplayOptions &options, std::mt19937 &rng) const
+    {
+        ReplayResult result;
+        std::vector<char> in;
+        std::vector<size_t> inLengths;
+        std::vector<char> out;
+        std::vector<size_t> outLengths;
+        ReplayDataBuffer input = {nullptr, 0, 0};
+        ReplayLengthBuffer inputLengths = {nullptr, 0, 0};
+        size_t dataPos = 0, messagePos = 0, minOutput = options.minOutput;
+        bool endOfFile = false;
+        const uint64_t maxCalls = 1000 + 4 * (data.size() + lengths.size());
+
+        refill(options, rng, in, inLengths, input, inputLengths, dataPos, messagePos, endOfFile);
+        while (true) {
+            out.resize(std::max(minOutput, random(rng, options.minOutput, options.maxOutput)));
+            outLengths.resize(random(rng, options.minOutputLengths, options.maxOutputLengths));
+            ReplayDataBuffer output = {out.data(), out.size(), 0};
+            ReplayLengthBuffer outputLengths = {outLengths.data(), outLengths.size(), 0};
+
+            // Only the filter is timed, not the copies of the harness into and out of the buffers
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            RecordStripper::Step step = stripper.process(input, inputLengths, endOfFile, output, outputLengths);
+            result.elapsed += std::chrono::steady_clock::now() - start;
+            ++result.calls;
+
+            // The parser consumes the output
+            size_t total = 0;
+            for (size_t i = 0; i < outputLengths.offset; ++i) {
+                result.lengths.push_back(outLengths[i]);
+                total += outLengths[i];
+            }
+            if (total != output.offset || output.offset > output.size || outputLengths.offset > outputLengths.size) {
+                result.error = "output lengths do not match the output";
+                return result;
+            }
+            result.output.append(out.data(), output.offset);
+
+            if (step == RecordStripper::STEP_DONE) {
+                if (!endOfFile || input.offset != input.size || inputLengths.offset != inputLengths.size) {
+                    result.error = "DONE before the end of the stream";
+                }
+                return result;
+            } else if (step == RecordStripper::STEP_NOT_STREAM) {
+                result.error = "no message lengths in the input";
+                return result;
+            } else if (step == RecordStripper::STEP_INPUT_NEEDED) {
+                ++result.inputNeeded;
+                if (endOfFile) {
+                    result.error = "INPUT_NEEDED at the end of the stream";
+                    return result;
+                }
+                refill(options, rng, in, inLengths, input, inputLengths, dataPos, messagePos, endOfFile);
+            } else {
+                ++result.outputNeeded;
+                if (output.offset == 0) { // Nothing fits
+                    minOutput = out.size() * 2;
+                }
+            }
+            if (result.calls > maxCalls) {
+                result.error = "too many calls";
+                return result;
+            }
+        }
+    }
+
+    /**
+     * Strip each message independently of the buffers.
+     */
+    static ReplayResult reference(const RecordPrefixLocator &locator, const std::string &schemaIdKey, const std::vector<std::string> &messages)
+    {
+        ReplayResult result;
+        for (const std::string &message : messages) {
+            RecordPrefix prefix = locator.locate(message.data(), message.size());
+            if (!prefix.found) {
+                continue;
+            }
+            std::string payload = message.substr(prefix.length);
+            if (prefix.hasSchemaId && !schemaIdKey.empty() && !payload.empty() && payload[0] == '{') {
+                size_t next = payload.find_first_not_of(" \t\n\r", 1);
+                bool emptyObject = next != std::string::npos && payload[next] == '}';
+                payload = "{\"" + schemaIdKey + "\":" + std::to_string(prefix.schemaId) + (emptyObject ? "" : ",") + payload.substr(1);
+            }
+            result.output += payload;
+            result.lengths.push_back(payload.size());
+        }
+        return result;
+    }
+
+    /**
+     * Read the messages written by 'kcat -C -f "%R%s"', which is a 4-byte big-endian length followed by the message.
+     */
+    static bool readRecording(const char *path, std::vector<std::string> &messages)
+    {
+        FILE *fp = fopen(path, "rb");
+        if (fp == nullptr) {
+            return false;
+        }
+        unsigned char header[4];
+        bool ok = true;
+        while (fread(header, 1, 4, fp) == 4) {
+            size_t length = (static_cast<size_t>(header[0]) << 24) | (header[1] << 16) | (header[2] << 8) | header[3];
+            std::string message(length, '\0');
+            if (length > 0 && fread(&message[0], 1, length, fp) != length) {
+                ok = false;
+                break;
+            }
+            messages.push_back(message);
+        }
+        fclose(fp);
+        return ok;
+    }
+
+private:
+    std::string data;            // Messages in the stream
+    std::vector<size_t> starts;  // Offset of each message
+    std::vector<size_t> lengths; // Length of each message
+
+    static size_t random(std::mt19937 &rng, size_t min, size_t max)
+    {
+        return min + (max > min ? rng() % (max - min + 1) : 0);
+    }
+
+    /**
+     * Keep the unprocessed input, and append the next bytes and lengths of the stream.
+     */
+    void refill(const ReplayOptions &options, std::mt19937 &rng, std::vector<char> &in, std::vector<size_t> &inLengths,
+                ReplayDataBuffer &input, ReplayLengthBuffer &inputLengths, size_t &dataPos, size_t &messagePos, bool &endOfFile) const
+    {
+        in.erase(in.begin(), in.begin() + input.offset);
+        inLengths.erase(inLengths.begin(), inLengths.begin() + inputLengths.offset);
+
+        size_t chunk = std::min(random(rng, options.minInput, options.maxInput), data.size() - dataPos);
+        in.insert(in.end(), data.begin() + dataPos, data.begin() + dataPos + chunk);
+        dataPos += chunk;
+        while (messagePos < lengths.size() && inLengths.size() < options.maxInputLengths
+               && starts[messagePos] + (lengths[messagePos] > 0 ? 1 : 0) <= dataPos) {
+            inLengths.push_back(lengths[messagePos++]);
+        }
+        endOfFile = dataPos == data.size() && messagePos == lengths.size();
+
+        input = {in.data(), in.size(), 0};
+        inputLengths = {inLengths.data(), inLengths.size(), 0};
+    }
+};
+
+#endif // REPLAY_HARNESS_HPP
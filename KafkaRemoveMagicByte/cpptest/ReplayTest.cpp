@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Test of RecordStripper replayed with random buffer boundaries against the stripping of each message
+ *
+ * Create Date: March 15, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ReplayHarness.hpp"
+
+using namespace std;
+
+/**
+ * Generate messages with and without the header of the Confluent wire format, prefixes of various lengths,
+ * empty objects, arrays, messages without JSON data and empty messages.
+ */
+static vector<string> generate(mt19937 &rng)
+{
+    static const char *payloads[] = {"{}", "{ }", "[1,2]", "nojson", "{\"a\":1}", "", "{\"s\":\"[{\"}"};
+    vector<string> messages(rng() % 120);
+    for (string &message : messages) {
+        switch (rng() % 4) {
+        case 0: // Confluent header with a schema ID up to 5 digits
+            message = string("\x00\x00\x00\x00", 4);
+            message[2] = static_cast<char>(rng() % 256);
+            message[3] = static_cast<char>(rng() % 256);
+            message += static_cast<char>(rng() % 256);
+            break;
+        case 1:
+            message = string(rng() % 40, 'x');
+            break;
+        default:
+            break;
+        }
+        message += payloads[rng() % (sizeof(payloads) / sizeof(payloads[0]))];
+        if (rng() % 16 == 0) { // Long message across many input chunks
+            message += string(200 + rng() % 800, ' ');
+        }
+    }
+    return messages;
+}
+
+int main()
+{
+    size_t failures = 0, rounds = 0;
+    uint64_t inputNeeded = 0, outputNeeded = 0;
+    mt19937 rng(20240315);
+
+    for (int round = 0; round < 20000; ++round) {
+        vector<string> messages = generate(rng);
+        bool confluent = rng() % 2 == 0;
+        RecordPrefixLocator locator(confluent ? RecordPrefixLocator::WIRE_FORMAT_CONFLUENT : RecordPrefixLocator::WIRE_FORMAT_NONE);
+        locator.setAcceptArrays(rng() % 2 == 0);
+        if (rng() % 4 == 0) {
+            locator.setMaxPrefixLength(rng() % 32);
+        }
+        string schemaIdKey = (confluent && rng() % 2 == 0) ? "schema_id" : "";
+        RecordStripper stripper(locator, schemaIdKey);
+        if (rng() % 2 == 0) {
+            stripper.setCopyMode(RecordStripper::COPY_PER_RECORD);
+        }
+
+        // Small buffers so that the messages are split at any byte, and more input lengths than output lengths
+        ReplayOptions options;
+        options.minInput = 1 + rng() % 16;
+        options.maxInput = options.minInput + rng() % 256;
+        options.maxInputLengths = 1 + rng() % 16;
+        options.minOutput = 1 + rng() % 16;
+        options.maxOutput = options.minOutput + rng() % 256;
+        options.minOutputLengths = 1;
+        options.maxOutputLengths = 1 + rng() % 4;
+
+        ReplayHarness harness(messages);
+        ReplayResult result = harness.replay(stripper, options, rng);
+        ReplayResult expected = ReplayHarness::reference(locator, schemaIdKey, messages);
+        ++rounds;
+        inputNeeded += result.inputNeeded;
+        outputNeeded += result.outputNeeded;
+        if (!result.error.empty() || result.output != expected.output || result.lengths != expected.lengths) {
+            if (failures < 10) {
+                fprintf(stderr, "FAIL round %d: %zu messages, input [%zu, %zu] x %zu, output [%zu, %zu] x %zu: %s\n", round, messages.size(),
+                       options.minInput, options.maxInput, options.maxInputLengths, options.minOutput, options.maxOutput, options.maxOutputLengths,
+                       result.error.empty() ? "output differs" : result.error.c_str());
+            }
+            ++failures;
+        }
+    }
+
+    printf("%s: %zu cases, %zu failures (%llu INPUT_NEEDED, %llu OUTPUT_NEEDED)\n", failures == 0 ? "PASS" : "FAIL", rounds, failures,
+           static_cast<unsigned long long>(inputNeeded), static_cast<unsigned long long>(outputNeeded));
+    return failures == 0 ? 0 : 1;
+}
@@ -10,3 +10,4 @@
 \set libfile '\''`pwd`'/KafkaRemoveMagicByte.so\''
 CREATE OR REPLACE LIBRARY KafkaRemoveMagicByteLib AS :libfile LANGUAGE 'C++';
 CREATE OR REPLACE FILTER KafkaRemoveMagicByte AS LANGUAGE 'C++' NAME 'KafkaRemoveMagicByteFactory' LIBRARY KafkaRemoveMagicByteLib NOT FENCED;
+CREATE OR REPLACE FILTER KafkaAvroToJson AS LANGUAGE 'C++' NAME 'KafkaAvroToJsonFactory' LIBRARY KafkaRemoveMagicByteLib NOT FENCED;
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: DelimiterUtil : Read the session parameters for the delimiter of StringTokenizerWithDelimiter library
+ *
+ * Create Date: September 12, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include "DelimiterUtil.hpp"
+
+using namespace std;
+
+// parameter names for the token filter
+const string SKIP_EMPTY_PARAM = "skip_empty";
+const string TRIM_PARAM = "trim";
+const string MIN_LENGTH_PARAM = "min_length";
+const string MAX_LENGTH_PARAM = "max_length";
+const string KEEP_TRAILING_EMPTY_PARAM = "keep_trailing_empty";
+
+/**
+ * Compile the delimiter, quote and escape session parameters of the library into the matcher and the splitter.
+ */
+void DelimiterUtil::readDelimiterParameters(ServerInterface &srvInterface, DelimiterMatcher &matcher, QuotedSplitter &splitter)
+{
+    ParamReader sessionParams = srvInterface.getUDSessionParamReader("library");
+    string paramValue = sessionParams.containsParameter("delimiter") ? sessionParams.getStringRef("delimiter").str() : ";";
+    if (paramValue.empty()) {
+        vt_report_error(0, "Function only accepts that 'delimiter' session parameter has 1 or more characters");
+    }
+    string modeValue = sessionParams.containsParameter("delimitermode") ? sessionParams.getStringRef("delimitermode").str() : "string";
+    if (modeValue != "string" && modeValue != "set") {
+        vt_report_error(0, "Function only accepts that 'delimitermode' session parameter is 'string' or 'set', but '%s' had", modeValue.c_str());
+    }
+    // The delimiter is compiled once here, and a single character keeps using memchr
+    matcher.compile(paramValue, modeValue == "set");
+
+    // Quote and escape characters, which must not be part of the delimiter
+    string quoteValue = sessionParams.containsParameter("quote") ? sessionParams.getStringRef("quote").str() : "";
+    string escapeValue = sessionParams.containsParameter("escape") ? sessionParams.getStringRef("escape").str() : "";
+    if (quoteValue.length() > 1 || escapeValue.length() > 1) {
+        vt_report_error(0, "Function only accepts that 'quote' and 'escape' session parameters have 0 or 1 character");
+    }
+    if ((!quoteValue.empty() && (paramValue.find(quoteValue[0]) != string::npos || quoteValue == escapeValue))
+        || (!escapeValue.empty() && paramValue.find(escapeValue[0]) != string::npos)) {
+        vt_report_error(0, "Function only accepts that 'quote', 'escape' and 'delimiter' session parameters have different characters");
+    }
+    splitter.compile(quoteValue, escapeValue);
+}
+
+/**
+ * Define the parameters of the token filter.
+ */
+void DelimiterUtil::addFilterParameters(SizedColumnTypes &parameterTypes)
+{
+    parameterTypes.addBool(SKIP_EMPTY_PARAM, SizedColumnTypes::Properties(true /* visible */, false /* required */, false /* canBeNull */,
+                                                                          "Flag to drop the empty tokens", false /* isSortedOnThis */));
+    parameterTypes.addBool(TRIM_PARAM, SizedColumnTypes::Properties(true /* visible */, false /* required */, false /* canBeNull */,
+                                                                    "Flag to remove the whitespace at both ends of token", false /* isSortedOnThis */));
+    parameterTypes.addInt(MIN_LENGTH_PARAM, SizedColumnTypes::Properties(true /* visible */, false /* required */, false /* canBeNull */,
+                                                                         "Min length of token", false /* isSortedOnThis */));
+    parameterTypes.addInt(MAX_LENGTH_PARAM, SizedColumnTypes::Properties(true /* visible */, false /* required */, false /* canBeNull */,
+                                                                         "Max length of token", false /* isSortedOnThis */));
+    parameterTypes.addBool(KEEP_TRAILING_EMPTY_PARAM, SizedColumnTypes::Properties(true /* visible */, false /* required */, false /* canBeNull */,
+                                                                                   "Flag to output an empty token after the delimiter at the end of string",
+                                                                                   false /* isSortedOnThis */));
+}
+
+/**
+ * Read the parameters of the token filter.
+ */
+void DelimiterUtil::readFilterParameters(ServerInterface &srvInterface, TokenFilter &filter)
+{
+    ParamReader paramReader = srvInterface.getParamReader();
+    filter = TokenFilter();
+    if (paramReader.containsParameter(SKIP_EMPTY_PARAM)) {
+        filter.skipEmpty = paramReader.getBoolRef(SKIP_EMPTY_PARAM) == vbool_true;
+    }
+    if (paramReader.containsParameter(TRIM_PARAM)) {
+        filter.trim = paramReader.getBoolRef(TRIM_PARAM) == vbool_true;
+    }
+    if (paramReader.containsParameter(KEEP_TRAILING_EMPTY_PARAM)) {
+        filter.trailingEmpty = paramReader.getBoolRef(KEEP_TRAILING_EMPTY_PARAM) == vbool_true;
+    }
+    if (paramReader.containsParameter(MIN_LENGTH_PARAM)) {
+        vint minLength = paramReader.getIntRef(MIN_LENGTH_PARAM);
+        if (minLength < 0) {
+            vt_report_error(0, "%s should be 0 or a positive number", MIN_LENGTH_PARAM.c_str());
+        }
+        filter.minLength = minLength;
+    }
+    if (paramReader.containsParameter(MAX_LENGTH_PARAM)) {
+        vint maxLength = paramReader.getIntRef(MAX_LENGTH_PARAM);
+        if (maxLength < 0 || static_cast<size_t>(maxLength) < filter.minLength) {
+            vt_report_error(0, "%s should be 0 or a positive number which is not less than %s", MAX_LENGTH_PARAM.c_str(), MIN_LENGTH_PARAM.c_str());
+        }
+        filter.maxLength = maxLength;
+    }
+}
@@ -0,0 +1,46 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: DelimiterUtil : Read the session parameters for the delimiter of StringTokenizerWithDelimiter library
+ *
+ * Create Date: September 12, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef DELIMITER_UTIL_HPP
+#define DELIMITER_UTIL_HPP
+
+#include "Vertica.h"
+#include "DelimiterMatcher.hpp"
+#include "QuotedSplitter.hpp"
+#include "TokenFilter.hpp"
+
+using namespace Vertica;
+
+// Maximum output length
+static const size_t MAX_TOKEN_LENGTH = 65000;
+
+/**
+ * DelimiterUtil : Utility class for the delimiter session parameters
+ */
+class DelimiterUtil
+{
+
+public:
+    /**
+     * Compile the delimiter, quote and escape session parameters of the library into the matcher and the splitter.
+     */
+    void readDelimiterParameters(ServerInterface &srvInterface, DelimiterMatcher &matcher, QuotedSplitter &splitter);
+
+    /**
+     * Define the parameters of the token filter.
+     */
+    void addFilterParameters(SizedColumnTypes &parameterTypes);
+
+    /**
+     * Read the parameters of the token filter.
+     */
+    void readFilterParameters(ServerInterface &srvInterface, TokenFilter &filter);
+};
+
+#endif // DELIMITER_UTIL_HPP
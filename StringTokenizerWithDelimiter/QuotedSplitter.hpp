@@ -0,0 +1,153 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: QuotedSplitter : Quote and escape aware splitting for StringTokenizerWithDelimiter
+ *
+ * Create Date: September 12, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef QUOTED_SPLITTER_HPP
+#define QUOTED_SPLITTER_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include "DelimiterMatcher.hpp"
+
+/**
+ * QuotedSplitter : Split the string at the delimiters which are neither quoted nor escaped
+ *
+ * - Delimiters between a pair of quote characters are part of the token, and the quote characters are removed.
+ * - The character after an escape character is taken literally, both inside and outside quotes, and the escape
+ *   character is removed. An escape character at the end of the string is removed.
+ * - A quote which is not closed extends to the end of the string.
+ *
+ * The next quote and escape characters are searched with memchr and remembered until they are passed,
+ * so an unquoted span costs about the same as the plain delimiter search. A token is built in a buffer
+ * only when it contains a quote or escape character; otherwise it is passed as the span of the input.
+ */
+class QuotedSplitter
+{
+
+public:
+    QuotedSplitter() {}
+
+    /**
+     * Set the quote and escape characters. An empty string disables each of them.
+     */
+    void compile(const std::string &quote, const std::string &escape)
+    {
+        hasQuote = !quote.empty();
+        hasEscape = !escape.empty();
+        quoteChar = hasQuote ? quote[0] : '\0';
+        escapeChar = hasEscape ? escape[0] : '\0';
+    }
+
+    bool enabled() const
+    {
+        return hasQuote || hasEscape;
+    }
+
+    /**
+     * Split the string and call emit(const char *word, size_t length) for each token.
+     * As in the plain split, an empty string has no token and a delimiter at the end makes an empty token
+     * only if trailingEmpty is true.
+     */
+    template <typename Emit>
+    void split(const DelimiterMatcher &matcher, const char *data, size_t len, Emit &&emit, bool trailingEmpty = false)
+    {
+        Cache quotes, escapes;
+        size_t pos = 0;
+        bool delimited = false; // The last token ended with a delimiter
+        while (pos < len) {
+            const size_t tokenStart = pos;
+            size_t spanStart = pos;
+            bool inQuote = false, buffered = false;
+            buffer.clear();
+            while (true) {
+                size_t q = hasQuote ? quotes.next(data, pos, len, quoteChar) : len;
+                size_t e = hasEscape ? escapes.next(data, pos, len, escapeChar) : len;
+                if (inQuote) {
+                    if (q < e) { // Closing quote
+                        buffer.append(data + spanStart, q - spanStart);
+                        inQuote = false;
+                        pos = spanStart = q + 1;
+                    } else if (e < len) {
+                        pos = spanStart = escape(data, spanStart, e, len);
+                    } else { // The quote is not closed
+                        buffer.append(data + spanStart, len - spanStart);
+                        pos = spanStart = len;
+                        inQuote = false;
+                    }
+                    continue;
+                }
+
+                size_t d = matcher.findNext(data, pos, q < e ? q : e);
+                if ((d < q && d < e) || d == len) { // Delimiter, or the end of the string
+                    if (buffered) {
+                        buffer.append(data + spanStart, d - spanStart);
+                        emit(buffer.data(), buffer.size());
+                    } else {
+                        emit(data + tokenStart, d - tokenStart);
+                    }
+                    pos = d + matcher.length();
+                    delimited = d < len;
+                    break;
+                }
+                buffered = true;
+                if (q < e) { // Opening quote
+                    buffer.append(data + spanStart, q - spanStart);
+                    inQuote = true;
+                    pos = spanStart = q + 1;
+                } else {
+                    pos = spanStart = escape(data, spanStart, e, len);
+                }
+            }
+        }
+        if (trailingEmpty && delimited && pos == len) {
+            emit(data + len, 0);
+        }
+    }
+
+private:
+    /**
+     * Cache : Position of the next occurrence of a character, which is valid until the position passes it
+     */
+    struct Cache {
+        size_t position = 0;
+        bool valid = false;
+
+        size_t next(const char *data, size_t pos, size_t len, char c)
+        {
+            if (!valid || position < pos) {
+                const void *found = pos < len ? memchr(data + pos, c, len - pos) : nullptr;
+                position = found == nullptr ? len : static_cast<const char *>(found) - data;
+                valid = true;
+            }
+            return position;
+        }
+    };
+
+    bool hasQuote = false;   // Quote character is set
+    bool hasEscape = false;  // Escape character is set
+    char quoteChar = '\0';   // Quote character
+    char escapeChar = '\0';  // Escape character
+    std::string buffer;      // Token with quotes and escapes removed
+
+    /**
+     * Append the span before the escape character at e and the escaped character, and return the next position.
+     */
+    size_t escape(const char *data, size_t spanStart, size_t e, size_t len)
+    {
+        buffer.append(data + spanStart, e - spanStart);
+        if (e + 1 < len) {
+            buffer += data[e + 1];
+            return e + 2;
+        }
+        return len;
+    }
+};
+
+#endif // QUOTED_SPLITTER_HPP
@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: StringSplitToArray : Scalar function that splits value by user-specified delimiter into an array
+ *
+ * Create Date: September 12, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include "Vertica.h"
+#include "Arrays/Accessors.h"
+#include <algorithm>
+
+#include "DelimiterUtil.hpp"
+
+using namespace Vertica;
+using namespace std;
+
+// default maximum number of elements of output array
+const int DEFAULT_MAX_ELEMENTS = 256;
+// parameter name for maximum number of elements of output array
+const string MAX_ELEMENTS = "max_elements";
+// parameter name for flag to truncate results when the number of tokens exceeds max_elements parameter
+const string ALLOW_TRUNCATE = "allow_truncate";
+
+/**
+ * StringSplitToArray : Scalar function class
+ */
+class StringSplitToArray : public ScalarFunction
+{
+
+private:
+    DelimiterMatcher matcher;                  // Matcher of the delimiter for tokenizer
+    QuotedSplitter splitter;                   // Quote and escape aware splitter, used when quote or escape is set
+    TokenFilter filter;                        // Trimming and filtering of tokens before they are written
+    bool filtering = false;                    // Flag to apply the filter, which is set when any filter parameter is set
+    size_t maxElements = DEFAULT_MAX_ELEMENTS; // Maximum number of elements of output array
+    bool allowTruncate = false;                // Flag to drop the tokens exceeding max_elements instead of an error
+
+public:
+
+    /**
+     * Perform per instance initialization.
+     */
+    void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) override
+    {
+        ParamReader paramReader = srvInterface.getParamReader();
+        if (paramReader.containsParameter(MAX_ELEMENTS)) {
+            maxElements = paramReader.getIntRef(MAX_ELEMENTS);
+        }
+        if (paramReader.containsParameter(ALLOW_TRUNCATE)) {
+            allowTruncate = paramReader.getBoolRef(ALLOW_TRUNCATE) == vbool_true;
+        }
+        DelimiterUtil().readDelimiterParameters(srvInterface, matcher, splitter);
+        DelimiterUtil().readFilterParameters(srvInterface, filter);
+        filtering = filter.enabled();
+    }
+
+    /**
+     * Process a block of rows.
+     */
+    void processBlock(ServerInterface &srvInterface,
+                      BlockReader &argReader,
+                      BlockWriter &resWriter) override
+    {
+        do {
+            const VString &sentence = argReader.getStringRef(0);
+
+            if (sentence.isNull()) { // If input string is NULL, then output is NULL as well
+                resWriter.setNull();
+            } else {
+                Array::ArrayWriter arrayWriter = resWriter.getArrayRef(0);
+                size_t elements = 0;
+                auto emit = [&](const char *data, size_t length) {
+                    if (filtering && !filter.apply(data, length)) { // Dropped tokens do not count for max_elements
+                        return;
+                    }
+                    if (elements < maxElements) {
+                        arrayWriter->getStringRef().copy(data, length < MAX_TOKEN_LENGTH ? length : MAX_TOKEN_LENGTH);
+                        arrayWriter->next();
+                        elements++;
+                    } else if (!allowTruncate) {
+                        vt_report_error(0, "Number of elements exceeded max number (%s = %zu)", MAX_ELEMENTS.c_str(), maxElements);
+                    }
+                };
+
+                if (splitter.enabled()) {
+                    splitter.split(matcher, sentence.data(), sentence.length(), emit, filter.trailingEmpty);
+                } else {
+                    matcher.split(sentence.data(), sentence.length(), emit, filter.trailingEmpty);
+                }
+                arrayWriter.commit();
+            }
+            resWriter.next();
+        } while (argReader.next());
+    }
+};
+
+/**
+ * StringSplitToArrayFactory : Scalar function factory class
+ */
+class StringSplitToArrayFactory : public ScalarFunctionFactory
+{
+
+public:
+
+    /**
+     * Define arguments and outputs.
+     */
+    void getPrototype(ServerInterface &srvInterface, ColumnTypes &argTypes, ColumnTypes &returnType) override
+    {
+        argTypes.addAny();
+        returnType.addAny();
+    }
+
+    /**
+     * Define parameters.
+     */
+    void getParameterType(ServerInterface &srvInterface, SizedColumnTypes &parameterTypes) override
+    {
+        parameterTypes.addInt(MAX_ELEMENTS, SizedColumnTypes::Properties(true /* visible */, false /* required */, false /* canBeNull */,
+                                                                         "Max number of elements", false /* isSortedOnThis */));
+        parameterTypes.addBool(ALLOW_TRUNCATE, SizedColumnTypes::Properties(true /* visible */, false /* required */, false /* canBeNull */,
+                                                                            "Flag to truncate results when the number of tokens exceeds max elements",
+                                                                            false /* isSortedOnThis */));
+        DelimiterUtil().addFilterParameters(parameterTypes);
+    }
+
+    /**
+     * Register the data type of outputs.
+     */
+    void getReturnType(ServerInterface &srvInterface,
+                       const SizedColumnTypes &inputTypes,
+                       SizedColumnTypes &outputTypes) override
+    {
+        if (inputTypes.getColumnCount() != 1) {
+            vt_report_error(0, "Function only accepts 1 argument, but %zu provided", inputTypes.getColumnCount());
+        }
+
+        if (!inputTypes.getColumnType(0).isStringType()) {
+            vt_report_error(0, "Argument to tokenizer must be of varchar type.");
+        }
+
+        int maxElements = DEFAULT_MAX_ELEMENTS;
+        ParamReader paramReader = srvInterface.getParamReader();
+        if (paramReader.containsParameter(MAX_ELEMENTS)) {
+            maxElements = paramReader.getIntRef(MAX_ELEMENTS);
+            if (maxElements <= 0) {
+                vt_report_error(0, "%s should be a positive number", MAX_ELEMENTS.c_str());
+            }
+        }
+
+        size_t input_len = inputTypes.getColumnType(0).getStringLength();
+        VerticaType elementType(VarcharOID, VerticaType::makeStringTypeMod(min(input_len, MAX_TOKEN_LENGTH)));
+        outputTypes.addArrayType(elementType, "tokens", maxElements);
+    }
+
+    ScalarFunction *createScalarFunction(ServerInterface &srvInterface) override
+    {
+        return vt_createFuncObj(srvInterface.allocator, StringSplitToArray);
+    }
+};
+
+RegisterFactory(StringSplitToArrayFactory);
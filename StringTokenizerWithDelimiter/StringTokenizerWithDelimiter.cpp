@@ -10,11 +10,22 @@
 #include "Vertica.h"
 #include <algorithm>
 
+#include "DelimiterUtil.hpp"
+
 using namespace Vertica;
 using namespace std;
 
-// Maximum output length
-static const size_t MAX_TOKEN_LENGTH = 65000;
+// parameter name for flag to add the ordinal output column
+const string ORDINAL_PARAM = "ordinal";
+
+/**
+ * Check if the ordinal output column is requested.
+ */
+static bool isOrdinalEnabled(ServerInterface &srvInterface)
+{
+    ParamReader paramReader = srvInterface.getParamReader();
+    return paramReader.containsParameter(ORDINAL_PARAM) && paramReader.getBoolRef(ORDINAL_PARAM) == vbool_true;
+}
 
 /**
  * StringTokenizerWithDelimiter : Transform function class
@@ -24,20 +35,114 @@ class StringTokenizerWithDelimiter : public TransformFunction
 
 private:
     vector<size_t> inputCols; // Data member to store the passed arguments
-    char delimiter;           // Delimiter for tokenizer
+    DelimiterMatcher matcher; // Matcher of the delimiter for tokenizer
+    QuotedSplitter splitter;  // Quote and escape aware splitter, used when quote or escape is set
+    TokenFilter filter;       // Trimming and filtering of tokens before they are written
+    bool filtering = false;   // Flag to apply the filter, which is set when any filter parameter is set
+    bool ordinal = false;     // Flag to output the position of token
+
+    /**
+     * PassThroughValue : Value of a pass-through column resolved once per input row
+     */
+    struct PassThroughValue {
+        enum Kind { KIND_INT, KIND_FLOAT, KIND_BOOL, KIND_STRING, KIND_GENERIC };
+
+        Kind kind;             // How the value is read and written
+        size_t inputIdx;       // Index of input column
+        size_t outputIdx;      // Index of output column
+        vint intValue;         // Value of INTEGER, including the null value
+        vfloat floatValue;     // Value of FLOAT, including the null value
+        vbool boolValue;       // Value of BOOLEAN, including the null value
+        const VString *string; // Value of string types, which is valid until the input moves to the next row
+    };
+    vector<PassThroughValue> passThrough; // Pass-through columns
+
+    /**
+     * Decide how each pass-through column is copied from its data type.
+     */
+    void setupPassThroughInputs(const SizedColumnTypes &argTypes)
+    {
+        passThrough.clear();
+        size_t outputIdx = ordinal ? 2 : 1;
+        for (size_t inputIdx = 2; inputIdx < inputCols.size(); inputIdx++) {
+            PassThroughValue value = PassThroughValue();
+            switch (argTypes.getColumnType(inputCols[inputIdx]).getTypeOid()) {
+            case Int8OID:
+                value.kind = PassThroughValue::KIND_INT;
+                break;
+            case Float8OID:
+                value.kind = PassThroughValue::KIND_FLOAT;
+                break;
+            case BoolOID:
+                value.kind = PassThroughValue::KIND_BOOL;
+                break;
+            case CharOID:
+            case VarcharOID:
+            case LongVarcharOID:
+                value.kind = PassThroughValue::KIND_STRING;
+                break;
+            default: // NUMERIC, date/time types etc.
+                value.kind = PassThroughValue::KIND_GENERIC;
+                break;
+            }
+            value.inputIdx = inputIdx;
+            value.outputIdx = outputIdx++;
+            passThrough.push_back(value);
+        }
+    }
+
+    /**
+     * Read the pass-through inputs of the current row.
+     */
+    void readPassThroughInputs(PartitionReader &inputReader)
+    {
+        for (PassThroughValue &value : passThrough) {
+            switch (value.kind) {
+            case PassThroughValue::KIND_INT:
+                value.intValue = inputReader.getIntRef(value.inputIdx);
+                break;
+            case PassThroughValue::KIND_FLOAT:
+                value.floatValue = inputReader.getFloatRef(value.inputIdx);
+                break;
+            case PassThroughValue::KIND_BOOL:
+                value.boolValue = inputReader.getBoolRef(value.inputIdx);
+                break;
+            case PassThroughValue::KIND_STRING:
+                value.string = &inputReader.getStringRef(value.inputIdx);
+                break;
+            default:
+                break;
+            }
+        }
+    }
 
     /**
-     * Check for pass-through inputs.
+     * Write the pass-through inputs of the current row to the output row.
      */
-    void handlePassThroughInputs(ServerInterface &srvInterface,
-                                 PartitionReader &inputReader,
+    void handlePassThroughInputs(PartitionReader &inputReader,
                                  PartitionWriter &outputWriter)
     {
-        if (inputCols.size() > 2) {
-            size_t outputIdx = 1;
-            for (size_t inputIdx = 2; inputIdx < inputCols.size(); inputIdx++) {
-                outputWriter.copyFromInput(outputIdx, inputReader, inputIdx);
-                outputIdx++;
+        for (const PassThroughValue &value : passThrough) {
+            switch (value.kind) {
+            case PassThroughValue::KIND_INT:
+                outputWriter.setInt(value.outputIdx, value.intValue);
+                break;
+            case PassThroughValue::KIND_FLOAT:
+                outputWriter.setFloat(value.outputIdx, value.floatValue);
+                break;
+            case PassThroughValue::KIND_BOOL:
+                outputWriter.setBool(value.outputIdx, value.boolValue);
+                break;
+            case PassThroughValue::KIND_STRING:
+                if (value.string->isNull()) {
+                    outputWriter.setNull(value.outputIdx);
+                } else {
+                    outputWriter.getStringRef(value.outputIdx).copy(value.string->data(), value.string->length());
+                }
+                break;
+            default:
+                outputWriter.copyFromInput(value.outputIdx, inputReader, value.inputIdx);
+                break;
             }
         }
     }
@@ -50,12 +155,11 @@ public:
     void setup(ServerInterface &srvInterface, const SizedColumnTypes &argTypes) override
     {
         argTypes.getArgumentColumns(inputCols);
-        ParamReader sessionParams = srvInterface.getUDSessionParamReader("library");
-        string paramValue = sessionParams.containsParameter("delimiter") ? sessionParams.getStringRef("delimiter").str() : ";";
-        if (paramValue.length() != 1) {
-            vt_report_error(0, "Function only accepts that 'delimiter' session parameter has 1 character, but %zu had", paramValue.length());
-        }
-        delimiter = paramValue[0];
+        ordinal = isOrdinalEnabled(srvInterface);
+        setupPassThroughInputs(argTypes);
+        DelimiterUtil().readDelimiterParameters(srvInterface, matcher, splitter);
+        DelimiterUtil().readFilterParameters(srvInterface, filter);
+        filtering = filter.enabled();
     }
 
     /**
@@ -69,30 +173,43 @@ public:
             vt_report_error(0, "Function only accepts 2 or more arguments, but %zu provided", inputReader.getNumCols());
         }
 
+        vint position = 0;
+        auto emit = [&](const char *data, size_t length) {
+            // The ordinal is the position in the string, so that it counts the dropped tokens as well
+            ++position;
+            if (filtering && !filter.apply(data, length)) { // Dropped before anything is written
+                return;
+            }
+
+            // The SDK has no way to refer to the input, so the token is copied into the output once
+            outputWriter.getStringRef(0).copy(data, length < MAX_TOKEN_LENGTH ? length : MAX_TOKEN_LENGTH);
+            if (ordinal) {
+                outputWriter.setInt(1, position);
+            }
+
+            handlePassThroughInputs(inputReader, outputWriter);
+            outputWriter.next();
+        };
+
         do {
             const VString &sentence = inputReader.getStringRef(1);
+            readPassThroughInputs(inputReader);
 
             if (sentence.isNull()) { // If input string is NULL, then output is NULL as well
                 VString &word = outputWriter.getStringRef(0);
                 word.setNull();
+                if (ordinal) {
+                    outputWriter.setInt(1, vint_null);
+                }
 
-                handlePassThroughInputs(srvInterface, inputReader, outputWriter);
+                handlePassThroughInputs(inputReader, outputWriter);
                 outputWriter.next();
             } else {
-                size_t word_start = 0, word_end = 0;
-
-                const char *s_data = sentence.data();
-                size_t s_len = sentence.length();
-
-                while (word_end < s_len) {
-                    for ( ; word_end < s_len && s_data[word_end] != delimiter; word_end++) {}
-
-                    VString &word = outputWriter.getStringRef(0);
-                    word.copy(&s_data[word_start], min((word_end - word_start), MAX_TOKEN_LENGTH));
-                    word_start = ++word_end;
-
-                    handlePassThroughInputs(srvInterface, inputReader, outputWriter);
-                    outputWriter.next();
+                position = 0;
+                if (splitter.enabled()) {
+                    splitter.split(matcher, sentence.data(), sentence.length(), emit, filter.trailingEmpty);
+                } else {
+                    matcher.split(sentence.data(), sentence.length(), emit, filter.trailingEmpty);
                 }
             }
         } while (inputReader.next());
@@ -116,6 +233,27 @@ public:
         returnType.addAny();
     }
 
+    /**
+     * Define parameters.
+     */
+    void getParameterType(ServerInterface &srvInterface, SizedColumnTypes &parameterTypes) override
+    {
+        parameterTypes.addBool(ORDINAL_PARAM, SizedColumnTypes::Properties(true /* visible */, false /* required */, false /* canBeNull */,
+                                                                           "Flag to output the 1-based position of token in the string", false /* isSortedOnThis */));
+        DelimiterUtil().addFilterParameters(parameterTypes);
+    }
+
+    /**
+     * Declare that each output row depends on one input row, so that Vertica can spread the input rows
+     * over the threads with PARTITION ROW or PARTITION BEST.
+     */
+    void getTransformFunctionProperties(ServerInterface &srvInterface,
+                                        const SizedColumnTypes &argTypes,
+                                        Properties &properties) override
+    {
+        properties.isExploder = true;
+    }
+
     /**
      * Register the data type of outputs.
      */
@@ -133,6 +271,9 @@ public:
 
         size_t input_len = inputTypes.getColumnType(1).getStringLength();
         outputTypes.addVarchar(min(input_len, MAX_TOKEN_LENGTH), "token");
+        if (isOrdinalEnabled(srvInterface)) {
+            outputTypes.addInt("ordinal");
+        }
 
         // Handle output rows for added pass-through inputs
         std::vector<size_t> argCols;
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: TokenFilter : Trim and filter the tokens of StringTokenizerWithDelimiter before they are written
+ *
+ * Create Date: September 12, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#ifndef TOKEN_FILTER_HPP
+#define TOKEN_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * TokenFilter : Trim the whitespace around the token, and drop the empty, too short or too long token
+ *
+ * The filter is applied to the span of the input before anything is written, so a dropped token costs no output row.
+ */
+struct TokenFilter
+{
+    bool skipEmpty = false;      // Drop the empty tokens
+    bool trim = false;           // Remove the whitespace at both ends of the token
+    bool trailingEmpty = false;  // Emit an empty token after a delimiter at the end of the string
+    size_t minLength = 0;        // Min length of token after trimming
+    size_t maxLength = SIZE_MAX; // Max length of token after trimming
+
+    /**
+     * Check if any token can be changed or dropped.
+     */
+    bool enabled() const
+    {
+        return skipEmpty || trim || minLength > 0 || maxLength != SIZE_MAX;
+    }
+
+    /**
+     * Trim the token and return false if it is dropped.
+     */
+    bool apply(const char *&word, size_t &length) const
+    {
+        if (trim) {
+            while (length > 0 && isSpace(word[0])) {
+                ++word;
+                --length;
+            }
+            while (length > 0 && isSpace(word[length - 1])) {
+                --length;
+            }
+        }
+        if (length == 0 && skipEmpty) {
+            return false;
+        }
+        return length >= minLength && length <= maxLength;
+    }
+
+private:
+    static bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+};
+
+#endif // TOKEN_FILTER_HPP
@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Benchmark of DelimiterMatcher kernels and QuotedSplitter across delimiters and token length distributions
+ *
+ * Create Date: September 12, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../DelimiterMatcher.hpp"
+#include "../QuotedSplitter.hpp"
+
+using namespace std;
+
+/**
+ * Generate rows of about rowSize bytes whose tokens have lengths uniformly distributed in [1, 2 * meanLength].
+ */
+static vector<string> generateRows(size_t numRows, size_t rowSize, size_t meanLength, const string &delimiter, mt19937 &rng)
+{
+    vector<string> rows(numRows);
+    for (string &row : rows) {
+        while (row.size() < rowSize) {
+            size_t length = 1 + rng() % (2 * meanLength);
+            for (size_t i = 0; i < length; ++i) {
+                row += static_cast<char>('a' + rng() % 26);
+            }
+            row += delimiter;
+        }
+    }
+    return rows;
+}
+
+/**
+ * Split all rows like processPartition does, and return the number of tokens.
+ */
+static size_t split(const DelimiterMatcher &matcher, const vector<string> &rows)
+{
+    size_t tokens = 0;
+    for (const string &row : rows) {
+        matcher.split(row.data(), row.size(), [&tokens](const char *, size_t) { ++tokens; });
+    }
+    return tokens;
+}
+
+/**
+ * Split all rows with the quote and escape aware splitter, and return the number of tokens.
+ */
+static size_t splitQuoted(QuotedSplitter &splitter, const DelimiterMatcher &matcher, const vector<string> &rows)
+{
+    size_t tokens = 0;
+    for (const string &row : rows) {
+        splitter.split(matcher, row.data(), row.size(), [&tokens](const char *, size_t) { ++tokens; });
+    }
+    return tokens;
+}
+
+static void run(const char *label, const string &delimiter, bool isSet, const string &rowDelimiter, int iterations, mt19937 &rng)
+{
+    const size_t rowSize = 4096, numRows = 16384; // 64 MB of 4 KB rows
+    for (size_t meanLength : {4, 16, 64, 256, 1024}) {
+        vector<string> rows = generateRows(numRows, rowSize, meanLength, rowDelimiter, rng);
+        size_t bytes = 0;
+        for (const string &row : rows) {
+            bytes += row.size();
+        }
+        for (DelimiterMatcher::Kernel kernel : {DelimiterMatcher::KERNEL_SCALAR, DelimiterMatcher::KERNEL_MEMCHR}) {
+            DelimiterMatcher matcher;
+            matcher.compile(delimiter, isSet);
+            matcher.setKernel(kernel);
+            size_t tokens = 0;
+            auto start = chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                tokens += split(matcher, rows);
+            }
+            double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            printf("%-16s %-12zu %-8s %10.2f %14.0f\n", label, meanLength,
+                   matcher.getMode() == DelimiterMatcher::MODE_SET ? "table" : kernel == DelimiterMatcher::KERNEL_SCALAR ? "scalar" : "memchr",
+                   static_cast<double>(bytes) * iterations / sec / 1e9, tokens / sec);
+            if (matcher.getMode() == DelimiterMatcher::MODE_SET) { // The kernel is not used
+                break;
+            }
+        }
+
+        // Quote and escape aware mode over the same rows, which have no quote or escape characters
+        DelimiterMatcher matcher;
+        matcher.compile(delimiter, isSet);
+        QuotedSplitter splitter;
+        splitter.compile("\"", "\\");
+        size_t tokens = 0;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            tokens += splitQuoted(splitter, matcher, rows);
+        }
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        printf("%-16s %-12zu %-8s %10.2f %14.0f\n", label, meanLength, "quoted",
+               static_cast<double>(bytes) * iterations / sec / 1e9, tokens / sec);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 5;
+    mt19937 rng(1);
+
+    printf("%-16s %-12s %-8s %10s %14s\n", "delimiter", "mean length", "kernel", "GB/s", "tokens/s");
+    run("';'", ";", false, ";", iterations, rng);
+    run("'||'", "||", false, "||", iterations, rng);
+    run("'\\r\\n'", "\r\n", false, "\r\n", iterations, rng);
+    run("set ';,|'", ";,|", true, ",", iterations, rng);
+    return 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: SQL script to measure StringTokenizerWithDelimiter across thread counts
+ *
+ * Create Date: September 12, 2024
+ * Author: Hibiki Serizawa
+ */
+
+-- Create Benchmark table
+CREATE TABLE public.stwd_scaling_bench (id INT, tags VARCHAR(8000), source VARCHAR(32), score FLOAT) SEGMENTED BY HASH(id) ALL NODES;
+
+-- Generate 2,000,000 rows of about 4 KB semicolon-delimited tags offline, then load them
+\! awk 'BEGIN { srand(1); for (i = 1; i <= 2000000; i++) { s = ""; while (length(s) < 4000) { s = s "tag" int(rand() * 100000) ";" } printf "%d|%s|source%d|%f\n", i, s, i % 16, rand() } }' > /tmp/stwd_scaling_bench.dat
+\! vsql -c "COPY public.stwd_scaling_bench FROM LOCAL '/tmp/stwd_scaling_bench.dat' DIRECT;"
+\! rm -f /tmp/stwd_scaling_bench.dat
+
+-- Resource pool to limit the number of threads per node
+CREATE RESOURCE POOL stwd_scaling_bench_pool;
+SET SESSION RESOURCE_POOL = stwd_scaling_bench_pool;
+
+\timing on
+
+-- Benchmark with 1, 2, 4, 8 and 16 threads, each with and without pass-through columns
+ALTER RESOURCE POOL stwd_scaling_bench_pool EXECUTIONPARALLELISM 1;
+SELECT COUNT(*) FROM (SELECT StringTokenizerWithDelimiter(id, tags) OVER (PARTITION ROW) FROM public.stwd_scaling_bench) s;
+SELECT COUNT(*) FROM (SELECT StringTokenizerWithDelimiter(id, tags, id, source, score) OVER (PARTITION ROW) FROM public.stwd_scaling_bench) s;
+
+ALTER RESOURCE POOL stwd_scaling_bench_pool EXECUTIONPARALLELISM 2;
+SELECT COUNT(*) FROM (SELECT StringTokenizerWithDelimiter(id, tags) OVER (PARTITION ROW) FROM public.stwd_scaling_bench) s;
+SELECT COUNT(*) FROM (SELECT StringTokenizerWithDelimiter(id, tags, id, source, score) OVER (PARTITION ROW) FROM public.stwd_scaling_bench) s;
+
+ALTER RESOURCE POOL stwd_scaling_bench_pool EXECUTIONPARALLELISM 4;
+SELECT COUNT(*) FROM (SELECT StringTokenizerWithDelimiter(id, tags) OVER (PARTITION ROW) FROM public.stwd_scaling_bench) s;
+SELECT COUNT(*) FROM (SELECT StringTokenizerWithDelimiter(id, tags, id, source, score) OVER (PARTITION ROW) FROM public.stwd_scaling_bench) s;
+
+ALTER RESOURCE POOL stwd_scaling_bench_pool EXECUTIONPARALLELISM 8;
+SELECT COUNT(*) FROM (SELECT StringTokenizerWithDelimiter(id, tags) OVER (PARTITION ROW) FROM public.stwd_scaling_bench) s;
+SELECT COUNT(*) FROM (SELECT StringTokenizerWithDelimiter(id, tags, id, source, score) OVER (PARTITION ROW) FROM public.stwd_scaling_bench) s;
+
+ALTER RESOURCE POOL stwd_scaling_bench_pool EXECUTIONPARALLELISM 16;
+SELECT COUNT(*) FROM (SELECT StringTokenizerWithDelimiter(id, tags) OVER (PARTITION ROW) FROM public.stwd_scaling_bench) s;
+SELECT COUNT(*) FROM (SELECT StringTokenizerWithDelimiter(id, tags, id, source, score) OVER (PARTITION ROW) FROM public.stwd_scaling_bench) s;
+
+-- For comparison, OVER () runs one instance per node
+SELECT COUNT(*) FROM (SELECT StringTokenizerWithDelimiter(id, tags) OVER () FROM public.stwd_scaling_bench) s;
+
+\timing off
+
+-- Drop Benchmark table and resource pool
+SET SESSION RESOURCE_POOL = general;
+DROP RESOURCE POOL stwd_scaling_bench_pool;
+DROP TABLE public.stwd_scaling_bench CASCADE;
@@ -0,0 +1,30 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: SQL script to compare StringSplitToArray with StringTokenizerWithDelimiter and implodeext
+ *
+ * Create Date: September 12, 2024
+ * Author: Hibiki Serizawa
+ */
+
+-- Create Benchmark table
+CREATE TABLE public.split_to_array_bench (id INT, tags VARCHAR(4000));
+
+-- Load Benchmark data (60 tags per row)
+\! for i in {1..100000}; do echo -n "${i}|"; for j in {1..59}; do echo -n "tag$(((${i} * ${j}) % 997));"; done; echo "tag${i}"; done | vsql -c 'COPY public.split_to_array_bench FROM LOCAL STDIN;'
+
+\timing on
+
+-- Benchmark 1: Scalar function returning ARRAY
+SELECT COUNT(*) FROM (SELECT id, StringSplitToArray(tags) AS tags FROM public.split_to_array_bench) s;
+
+-- Benchmark 2: Transform function exploding rows, then implodeext (requires implodeext to be installed)
+SELECT COUNT(*) FROM (SELECT id, implodeext(token) OVER (PARTITION BY id) AS tags FROM (SELECT StringTokenizerWithDelimiter(id, tags, id) OVER (PARTITION BEST) FROM public.split_to_array_bench) t) s;
+
+-- Benchmark 3: Filter with CONTAINS on ARRAY
+SELECT COUNT(*) FROM public.split_to_array_bench WHERE CONTAINS(StringSplitToArray(tags), 'tag1');
+
+\timing off
+
+-- Drop Benchmark table
+DROP TABLE public.split_to_array_bench CASCADE;
@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Test of DelimiterMatcher against the byte-by-byte search and the naive string search
+ *
+ * Create Date: September 12, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../DelimiterMatcher.hpp"
+
+using namespace std;
+
+/**
+ * Split the string like processPartition does.
+ */
+static vector<string> split(const DelimiterMatcher &matcher, const string &sentence, bool trailingEmpty = false)
+{
+    vector<string> tokens;
+    matcher.split(sentence.data(), sentence.size(), [&](const char *word, size_t length) {
+        tokens.push_back(string(word, length));
+    }, trailingEmpty);
+    return tokens;
+}
+
+/**
+ * Split the string with std::string::find or find_first_of.
+ */
+static vector<string> naiveSplit(const string &delimiter, bool isSet, const string &sentence)
+{
+    vector<string> tokens;
+    size_t word_start = 0;
+    while (word_start < sentence.size()) {
+        size_t word_end = isSet ? sentence.find_first_of(delimiter, word_start) : sentence.find(delimiter, word_start);
+        if (word_end == string::npos) {
+            word_end = sentence.size();
+        }
+        tokens.push_back(sentence.substr(word_start, word_end - word_start));
+        word_start = word_end + (isSet ? 1 : delimiter.size());
+    }
+    return tokens;
+}
+
+int main()
+{
+    size_t failures = 0, cases = 0;
+    mt19937 rng(20240912);
+    const string alphabet("ab;;-\xff\0", 7);
+
+    for (int round = 0; round < 20000; ++round) {
+        string sentence;
+        size_t len = rng() % 300;
+        for (size_t i = 0; i < len; ++i) {
+            sentence += alphabet[rng() % alphabet.size()];
+        }
+        char delimiter = alphabet[rng() % alphabet.size()];
+
+        DelimiterMatcher scalar, memchr;
+        scalar.compile(delimiter);
+        scalar.setKernel(DelimiterMatcher::KERNEL_SCALAR);
+        memchr.compile(delimiter);
+
+        ++cases;
+        if (split(scalar, sentence) != split(memchr, sentence)) {
+            fprintf(stderr, "FAIL delimiter=0x%02x length=%zu\n", static_cast<unsigned char>(delimiter), sentence.size());
+            ++failures;
+        }
+    }
+
+    // Multi-character delimiters and sets of delimiters
+    for (int round = 0; round < 20000; ++round) {
+        string sentence, delimiter;
+        size_t len = rng() % 300;
+        for (size_t i = 0; i < len; ++i) {
+            sentence += alphabet[rng() % alphabet.size()];
+        }
+        for (size_t i = 0, n = 1 + rng() % 4; i < n; ++i) {
+            delimiter += alphabet[rng() % alphabet.size()];
+        }
+        bool isSet = rng() % 2 == 0;
+
+        for (DelimiterMatcher::Kernel kernel : {DelimiterMatcher::KERNEL_SCALAR, DelimiterMatcher::KERNEL_MEMCHR}) {
+            DelimiterMatcher matcher;
+            matcher.compile(delimiter, isSet);
+            matcher.setKernel(kernel);
+            ++cases;
+            if (split(matcher, sentence) != naiveSplit(delimiter, isSet, sentence)) {
+                fprintf(stderr, "FAIL delimiter length=%zu set=%d length=%zu\n", delimiter.size(), isSet, sentence.size());
+                ++failures;
+            }
+        }
+    }
+
+    // Cases in README.md
+    DelimiterMatcher matcher;
+    matcher.compile(';');
+    ++cases;
+    if (split(matcher, "fa;sol;la;si;do") != vector<string>({"fa", "sol", "la", "si", "do"})
+        || split(matcher, "a;;b;") != vector<string>({"a", "", "b"}) || !split(matcher, "").empty()) {
+        fprintf(stderr, "FAIL examples\n");
+        ++failures;
+    }
+    matcher.compile("||");
+    ++cases;
+    if (split(matcher, "a||b|c||||d") != vector<string>({"a", "b|c", "", "d"}) || matcher.getMode() != DelimiterMatcher::MODE_STRING) {
+        fprintf(stderr, "FAIL string delimiter\n");
+        ++failures;
+    }
+    matcher.compile("\r\n", true);
+    ++cases;
+    if (split(matcher, "a\r\nb\nc") != vector<string>({"a", "", "b", "c"}) || matcher.getMode() != DelimiterMatcher::MODE_SET) {
+        fprintf(stderr, "FAIL set of delimiters\n");
+        ++failures;
+    }
+
+    // Empty token after the delimiter at the end of the string
+    matcher.compile(';');
+    ++cases;
+    if (split(matcher, "a;;b;", true) != vector<string>({"a", "", "b", ""}) || split(matcher, "a;b", true) != vector<string>({"a", "b"})
+        || split(matcher, ";", true) != vector<string>({"", ""}) || !split(matcher, "", true).empty()) {
+        fprintf(stderr, "FAIL trailing empty token\n");
+        ++failures;
+    }
+    matcher.compile("||");
+    ++cases;
+    if (split(matcher, "a||", true) != vector<string>({"a", ""}) || split(matcher, "a|", true) != vector<string>({"a|"})) {
+        fprintf(stderr, "FAIL trailing empty token of string delimiter\n");
+        ++failures;
+    }
+
+    printf("%s: %zu cases, %zu failures\n", failures == 0 ? "PASS" : "FAIL", cases, failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Test of QuotedSplitter against a character-by-character state machine
+ *
+ * Create Date: September 12, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../QuotedSplitter.hpp"
+
+using namespace std;
+
+/**
+ * Split the string one character at a time.
+ */
+static vector<string> reference(const string &delimiter, bool isSet, const string &quote, const string &escape, const string &sentence,
+                                bool trailingEmpty)
+{
+    vector<string> tokens;
+    size_t i = 0;
+    const size_t len = sentence.size();
+    bool delimited = false;
+    while (i < len) {
+        string token;
+        bool inQuote = false;
+        delimited = false;
+        while (i < len) {
+            char c = sentence[i];
+            if (!escape.empty() && c == escape[0]) {
+                if (i + 1 < len) {
+                    token += sentence[i + 1];
+                }
+                i += 2;
+            } else if (!quote.empty() && c == quote[0]) {
+                inQuote = !inQuote;
+                ++i;
+            } else if (!inQuote && isSet && delimiter.find(c) != string::npos) {
+                ++i;
+                delimited = true;
+                break;
+            } else if (!inQuote && !isSet && sentence.compare(i, delimiter.size(), delimiter) == 0) {
+                i += delimiter.size();
+                delimited = true;
+                break;
+            } else {
+                token += c;
+                ++i;
+            }
+        }
+        tokens.push_back(token);
+    }
+    if (trailingEmpty && delimited) {
+        tokens.push_back("");
+    }
+    return tokens;
+}
+
+static vector<string> split(QuotedSplitter &splitter, const DelimiterMatcher &matcher, const string &sentence, bool trailingEmpty = false)
+{
+    vector<string> tokens;
+    splitter.split(matcher, sentence.data(), sentence.size(), [&](const char *word, size_t length) {
+        tokens.push_back(string(word, length));
+    }, trailingEmpty);
+    return tokens;
+}
+
+int main()
+{
+    size_t failures = 0, cases = 0;
+    mt19937 rng(20240912);
+    const string alphabet = "ab;;|\"\\";
+    const char *delimiters[] = {";", "||", ";|"};
+
+    for (int round = 0; round < 50000; ++round) {
+        string sentence;
+        size_t len = rng() % 100;
+        for (size_t i = 0; i < len; ++i) {
+            sentence += alphabet[rng() % alphabet.size()];
+        }
+        string delimiter = delimiters[rng() % 3];
+        bool isSet = rng() % 2 == 0;
+        string quote = (rng() % 4 != 0) ? "\"" : "";
+        string escape = (rng() % 4 != 0) ? "\\" : "";
+        bool trailingEmpty = rng() % 2 == 0;
+
+        DelimiterMatcher matcher;
+        matcher.compile(delimiter, isSet);
+        QuotedSplitter splitter;
+        splitter.compile(quote, escape);
+
+        ++cases;
+        if (split(splitter, matcher, sentence, trailingEmpty) != reference(delimiter, isSet, quote, escape, sentence, trailingEmpty)) {
+            fprintf(stderr, "FAIL sentence=[%s] delimiter=[%s] set=%d quote=[%s] escape=[%s] trailing=%d\n",
+                    sentence.c_str(), delimiter.c_str(), isSet, quote.c_str(), escape.c_str(), trailingEmpty);
+            ++failures;
+        }
+    }
+
+    // Cases in README.md
+    DelimiterMatcher matcher;
+    QuotedSplitter splitter;
+    splitter.compile("\"", "\\");
+    ++cases;
+    if (split(splitter, matcher, "a;\"b;c\";d") != vector<string>({"a", "b;c", "d"})
+        || split(splitter, matcher, "a\\;b;c") != vector<string>({"a;b", "c"})) {
+        fprintf(stderr, "FAIL examples\n");
+        ++failures;
+    }
+
+    printf("%s: %zu cases, %zu failures\n", failures == 0 ? "PASS" : "FAIL", cases, failures);
+    return failures == 0 ? 0 : 1;
+}
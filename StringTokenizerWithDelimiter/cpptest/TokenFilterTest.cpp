@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2024 Hibiki Serizawa
+ *
+ * Description: Test of TokenFilter with the trimming and the length filters
+ *
+ * Create Date: September 12, 2024
+ * Author: Hibiki Serizawa
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../DelimiterMatcher.hpp"
+#include "../TokenFilter.hpp"
+
+using namespace std;
+
+/**
+ * Split and filter the string like processPartition does.
+ */
+static vector<string> split(const TokenFilter &filter, const string &sentence)
+{
+    DelimiterMatcher matcher;
+    matcher.compile(';');
+    vector<string> tokens;
+    matcher.split(sentence.data(), sentence.size(), [&](const char *word, size_t length) {
+        if (filter.apply(word, length)) {
+            tokens.push_back(string(word, length));
+        }
+    }, filter.trailingEmpty);
+    return tokens;
+}
+
+int main()
+{
+    size_t failures = 0, cases = 0;
+    const string sentence = " do ;;re;\tmi\t; ;fa;sol  ;";
+
+    TokenFilter filter;
+    ++cases;
+    if (filter.enabled() || split(filter, sentence) != vector<string>({" do ", "", "re", "\tmi\t", " ", "fa", "sol  "})) {
+        fprintf(stderr, "FAIL default\n");
+        ++failures;
+    }
+
+    filter = TokenFilter();
+    filter.skipEmpty = true;
+    ++cases;
+    if (!filter.enabled() || split(filter, sentence) != vector<string>({" do ", "re", "\tmi\t", " ", "fa", "sol  "})) {
+        fprintf(stderr, "FAIL skip_empty\n");
+        ++failures;
+    }
+
+    filter = TokenFilter();
+    filter.trim = true;
+    ++cases;
+    if (split(filter, sentence) != vector<string>({"do", "", "re", "mi", "", "fa", "sol"})) {
+        fprintf(stderr, "FAIL trim\n");
+        ++failures;
+    }
+
+    filter.skipEmpty = true;
+    filter.trailingEmpty = true;
+    ++cases;
+    if (split(filter, sentence) != vector<string>({"do", "re", "mi", "fa", "sol"})) {
+        fprintf(stderr, "FAIL trim and skip_empty\n");
+        ++failures;
+    }
+
+    filter = TokenFilter();
+    filter.trailingEmpty = true;
+    ++cases;
+    if (split(filter, "a;b;") != vector<string>({"a", "b", ""})) {
+        fprintf(stderr, "FAIL keep_trailing_empty\n");
+        ++failures;
+    }
+
+    filter = TokenFilter();
+    filter.trim = true;
+    filter.minLength = 2;
+    filter.maxLength = 2;
+    ++cases;
+    if (split(filter, sentence) != vector<string>({"do", "re", "mi", "fa"})) {
+        fprintf(stderr, "FAIL min_length and max_length\n");
+        ++failures;
+    }
+
+    printf("%s: %zu cases, %zu failures\n", failures == 0 ? "PASS" : "FAIL", cases, failures);
+    return failures == 0 ? 0 : 1;
+}
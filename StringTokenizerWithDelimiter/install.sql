@@ -10,3 +10,4 @@
 \set libfile '\''`pwd`'/StringTokenizerWithDelimiter.so\''
 CREATE OR REPLACE LIBRARY StringTokenizerWithDelimiterLib AS :libfile LANGUAGE 'C++';
 CREATE OR REPLACE TRANSFORM FUNCTION StringTokenizerWithDelimiter AS LANGUAGE 'C++' NAME 'StringTokenizerWithDelimiterFactory' LIBRARY StringTokenizerWithDelimiterLib NOT FENCED;
+CREATE OR REPLACE FUNCTION StringSplitToArray AS LANGUAGE 'C++' NAME 'StringSplitToArrayFactory' LIBRARY StringTokenizerWithDelimiterLib NOT FENCED;